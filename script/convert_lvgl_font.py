@@ -80,7 +80,7 @@ if __name__ == "__main__":
             glyph_id_ofs_list = f"{font_name}_glyph_id_ofs_list_0"
             glyph_id_ofs_list_0_block = maybe_glyph_id_ofs_list_0.replace(
                 "glyph_id_ofs_list_0", glyph_id_ofs_list
-            )
+            ).replace("static const", "static constexpr")
 
     print(f"Line height: {line_height}")
     print(f"Range: {range_start}-{int(range_start) + int(range_length)}")
@@ -103,7 +103,7 @@ if __name__ == "__main__":
 
 {glyph_id_ofs_list_0_block}
 
-lv_font_t {font_name} = {{
+constexpr lv_font_t {font_name} = {{
   .h_top_skip_px = 0,
   .h_bot_skip_px = 0,
   .spacing_px = 1,
@@ -126,6 +126,8 @@ lv_font_t {font_name} = {{
         " glyph_bitmap": f" {font_name}_glyph_bitmap",
         " glyph_dsc": f" {font_name}_glyph_dsc",
         " LV_ATTRIBUTE_LARGE_CONST": "",
+        # The glyph descriptions are read at compile time to build the glyph table of LvFontWrapper
+        "static const lv_font_fmt_txt_glyph_dsc_t": "static constexpr lv_font_fmt_txt_glyph_dsc_t",
     }
 
     for search, replace in find_replace.items():
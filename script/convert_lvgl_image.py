@@ -0,0 +1,105 @@
+"""Convert an image from https://lvgl.io/tools/imageconverter (True color, 8 bit per channel) or an image header of this
+project to a header with the pixels already packed in RGB444, the format of the framebuffer."""
+
+import argparse
+import os
+import re
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Convert an image file from LVGL's converter to a packed RGB444 image header"
+    )
+    parser.add_argument(
+        "-i", "--input-file", help="Path to the file.c image file from LVGL or an existing image header"
+    )
+    parser.add_argument(
+        "-o", "--output-file", help="Output path to the generated output file"
+    )
+    parser.add_argument(
+        "-n", "--name", help="Name of the image variable, e.g. cat_sleep_image"
+    )
+    parser.add_argument("--width", type=int, help="Width in pixel, read from the input file if not set")
+    parser.add_argument("--height", type=int, help="Height in pixel, read from the input file if not set")
+    parser.add_argument(
+        "--alpha",
+        action=argparse.BooleanOptionalAction,
+        default=None,
+        help="Whether the pixels have an alpha channel (4 bytes per pixel), read from the input file if not set",
+    )
+    args = parser.parse_args()
+
+    with open(args.input_file) as file:
+        file_content = file.read()
+
+    # Either "w_px = 32" from our headers or ".header.w = 32" from LVGL
+    def find_value(patterns):
+        for pattern in patterns:
+            match = re.search(pattern, file_content)
+            if match:
+                return match.group(1)
+        return None
+
+    width = args.width or int(find_value([r"\.w_px\s*=\s*(\d+)", r"\.header\.w\s*=\s*(\d+)"]))
+    height = args.height or int(find_value([r"\.h_px\s*=\s*(\d+)", r"\.header\.h\s*=\s*(\d+)"]))
+    has_alpha = args.alpha
+    if has_alpha is None:
+        alpha_value = find_value([r"\.has_alpha\s*=\s*(\w+)"])
+        if alpha_value is not None:
+            has_alpha = alpha_value == "true"
+        else:
+            has_alpha = "LV_IMG_CF_TRUE_COLOR_ALPHA" in file_content
+    bytes_per_px = 4 if has_alpha else 3
+
+    # The bitmap is the first array of the file
+    bitmap_block = file_content.partition("[] = ")[2].partition("};")[0]
+    bitmap_block = re.sub(r"/\*.*?\*/|//[^\n]*", "", bitmap_block, flags=re.DOTALL)
+    data = [int(value, 16) for value in re.findall(r"0x[0-9a-fA-F]{1,2}", bitmap_block)]
+    if len(data) != width * height * bytes_per_px:
+        raise RuntimeError(
+            f"Expected {width * height * bytes_per_px} bytes for {width}x{height} px, found {len(data)} bytes"
+        )
+    print(f"Image: {width}x{height} px, alpha: {has_alpha}")
+
+    # Pixels are BGR(A). Two pixels are packed in three bytes, rows with an odd width are padded with a black pixel so
+    # that every row starts on a byte.
+    packed = []
+    for y in range(height):
+        row = []
+        for x in range(width):
+            offset = (y * width + x) * bytes_per_px
+            b = data[offset] >> 4
+            g = data[offset + 1] >> 4
+            r = data[offset + 2] >> 4
+            row.append((r << 8) | (g << 4) | b)
+        if width % 2 != 0:
+            row.append(0)
+        for left, right in zip(row[0::2], row[1::2]):
+            packed += [left >> 4, ((left & 0xF) << 4) | (right >> 8), right & 0xFF]
+    print(f"Size: {len(data)} bytes -> {len(packed)} bytes")
+
+    lines = []
+    for i in range(0, len(packed), 24):
+        lines.append("  " + ", ".join(f"0x{value:02x}" for value in packed[i : i + 24]) + ",")
+    bitmap = "\n".join(lines)
+
+    name = args.name
+    guard = os.path.basename(args.output_file).upper().replace(".", "_") + "_"
+    file_content_output = f"""#ifndef {guard}
+#define {guard}
+
+#include "draw_primitives.h"
+
+// clang-format off
+static const uint8_t {name}_bitmap[] = {{
+  // RGB444, 2 pixels packed in 3 bytes
+{bitmap}
+}};
+// clang-format on
+
+const rgb444_img_dsc_t {name} = {{.w_px = {width}, .h_px = {height}, .data = {name}_bitmap}};
+
+#endif  // {guard}
+"""
+
+    with open(args.output_file, "w") as file:
+        file.write(file_content_output)
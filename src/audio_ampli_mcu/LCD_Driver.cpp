@@ -28,18 +28,30 @@
 #
 ******************************************************************************/
 #include "LCD_Driver.h"
+#include "fixed_point.h"
+#include "packed_fill.h"
+#include "surface.h"
 
 #include "RP2040_PWM.h"
 
 #ifdef SIM
 #include "sim/arduino.h"
+#endif
+#if defined(SIM) && !defined(BENCH)
+#include "sim/overdraw_profiler.h"
+// The simulator counts the writes of each pixel of the framebuffer, to find where the drawing time goes. The bench
+// times the drawing itself, without it.
+#define COUNT_PIXEL_WRITES(_x, _y, _width, _height) overdraw_count_writes(_x, _y, _width, _height)
 #else
+#define COUNT_PIXEL_WRITES(_x, _y, _width, _height)
 #endif
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cstring>
 #include <cstdlib>
+#include <utility>
 
 /// PWM instance to control backlight
 RP2040_PWM pwm_backlight(pin_out::lcd_backlight.pin, 100000, LCD_BACKLIGHT);
@@ -117,6 +129,11 @@ void LCD_Init(void)
   LCD_Write_Command(0x36);  // MADCTL (36h): Memory Data Access Control
   LCD_WriteData_Byte(0xA0);
 
+  LCD_Write_Command(LCD_REG_VSCRDEF);  // (33h): Vertical Scrolling Definition, the whole panel scrolls
+  LCD_WriteData_Word(0);
+  LCD_WriteData_Word(LCD_WIDTH);
+  LCD_WriteData_Word(0);
+
   LCD_Write_Command(0x3A);  // COLMOD (3Ah): Interface Pixel Format
   // LCD_WriteData_Byte(0x05); // 16bit/pixel
   LCD_WriteData_Byte(0x03);  // 12bit/pixel
@@ -216,6 +233,11 @@ void Display::gpio_init()
 void Display::init()
 {
   LCD_Init();
+  // Whatever is in the screen memory at power up must be overwritten
+  mark_all_dirty();
+#ifdef LCD_SHADOW_DIFF
+  is_shadow_valid_ = false;
+#endif
 }
 
 void Display::set_backlight(uint16_t value)
@@ -240,25 +262,954 @@ void Display::set_window(const uint16_t x_start, const uint16_t y_start, const u
   LCD_Write_Command(LCD_REG_MEM_WRITE);
 }
 
-void Display::blip_framebuffer()
+void Display::mark_dirty(const Rect& rect_)
+{
+  // Drawing into a surface doesn't change the screen
+  if (onscreen_buffer_ != nullptr)
+  {
+    return;
+  }
+  Rect rect = rect_;
+  rect.clip_to_screen();
+  if (rect.is_empty())
+  {
+    return;
+  }
+  const uint32_t first_col = rect.x_start / tile_size_px;
+  const uint32_t last_col = (rect.x_end - 1) / tile_size_px;
+  const uint32_t cols_mask = ((2u << last_col) - 1) & ~((1u << first_col) - 1);
+  const int32_t last_row = (rect.y_end - 1) / tile_size_px;
+  for (int32_t row = rect.y_start / tile_size_px; row <= last_row; ++row)
+  {
+    dirty_tiles_[row] |= cols_mask;
+  }
+}
+
+void Display::mark_all_dirty()
+{
+  for (uint32_t& row : dirty_tiles_)
+  {
+    row = (1u << tile_cols) - 1;
+  }
+}
+
+void Display::add_dirty_window(const Rect& span)
+{
+  for (uint8_t i = 0; i < dirty_rect_count_; ++i)
+  {
+    Rect& window = dirty_rects_[i];
+    // Already pushed by a window grown to make room
+    if (window.contains(span))
+    {
+      return;
+    }
+    // Extend the window of the tile row above if it covers the same columns
+    if (window.y_end == span.y_start && window.x_start == span.x_start && window.x_end == span.x_end)
+    {
+      window.y_end = span.y_end;
+      return;
+    }
+  }
+
+  if (dirty_rect_count_ < max_dirty_rects)
+  {
+    dirty_rects_[dirty_rect_count_] = span;
+    ++dirty_rect_count_;
+    return;
+  }
+
+  // No more room, grow the window which will add the least amount of pixels
+  uint8_t best_idx = 0;
+  uint32_t best_cost = UINT32_MAX;
+  for (uint8_t i = 0; i < dirty_rect_count_; ++i)
+  {
+    const uint32_t cost = dirty_rects_[i].united(span).area() - dirty_rects_[i].area();
+    if (cost < best_cost)
+    {
+      best_cost = cost;
+      best_idx = i;
+    }
+  }
+  dirty_rects_[best_idx] = dirty_rects_[best_idx].united(span);
+}
+
+void Display::coalesce_dirty_tiles()
+{
+  dirty_rect_count_ = 0;
+  for (uint32_t row = 0; row < tile_rows; ++row)
+  {
+    uint32_t cols = dirty_tiles_[row];
+    dirty_tiles_[row] = 0;
+    // Each run of consecutive dirty tiles on the row is a span
+    while (cols != 0)
+    {
+      const uint32_t first_col = __builtin_ctz(cols);
+      const uint32_t run_len = __builtin_ctz(~(cols >> first_col));
+      cols &= ~(((1u << run_len) - 1) << first_col);
+      add_dirty_window(Rect{
+        .x_start = static_cast<int32_t>(first_col * tile_size_px),
+        .y_start = static_cast<int32_t>(row * tile_size_px),
+        .x_end = static_cast<int32_t>((first_col + run_len) * tile_size_px),
+        .y_end = static_cast<int32_t>((row + 1) * tile_size_px)});
+    }
+  }
+
+  // Merge the windows that cost less in extra pixels than the overhead of a window
+  while (dirty_rect_count_ > 1)
+  {
+    uint8_t best_i = 0;
+    uint8_t best_j = 0;
+    uint32_t best_cost = UINT32_MAX;
+    for (uint8_t i = 0; i < dirty_rect_count_; ++i)
+    {
+      for (uint8_t j = i + 1; j < dirty_rect_count_; ++j)
+      {
+        const uint32_t merged_area = dirty_rects_[i].united(dirty_rects_[j]).area();
+        const uint32_t separate_area = dirty_rects_[i].area() + dirty_rects_[j].area();
+        const uint32_t cost = merged_area > separate_area ? merged_area - separate_area : 0;
+        if (cost < best_cost)
+        {
+          best_cost = cost;
+          best_i = i;
+          best_j = j;
+        }
+      }
+    }
+    if (best_cost > window_overhead_px)
+    {
+      break;
+    }
+    dirty_rects_[best_i] = dirty_rects_[best_i].united(dirty_rects_[best_j]);
+    --dirty_rect_count_;
+    dirty_rects_[best_j] = dirty_rects_[dirty_rect_count_];
+  }
+}
+
+/// Is a DMA transfer to the screen on-going, in which case the chip select is low and the SPI transaction is open
+static DEV_THREAD_LOCAL bool is_async_transfer_running = false;
+
+/// Release the SPI bus if the DMA transfer is done. Returns true when the bus is free.
+static bool LCD_poll_async_transfer()
+{
+  if (!is_async_transfer_running)
+  {
+    return true;
+  }
+  if (!SPI.finishedAsync())
+  {
+    return false;
+  }
+  DEV_Digital_Write(pin_out::lcd_chip_select.pin, 1);
+  DEV_SPI_END_TRANS;
+  is_async_transfer_running = false;
+  return true;
+}
+
+void LCD_finish_async_transfer()
+{
+  while (!LCD_poll_async_transfer())
+  {
+  }
+}
+
+#ifdef LCD_DISPLAY_LIST
+void Display::record_command(const DrawCommand& command)
+{
+  if (command.bounds.is_empty())
+  {
+    return;
+  }
+  if (command_count_ == max_commands)
+  {
+    // Rasterizing the first commands now gives the same pixels, only the later ones can't hide them anymore
+    flush_commands();
+  }
+  commands_[command_count_] = command;
+  ++command_count_;
+}
+
+#ifndef LCD_BAND_RENDERING
+void Display::flush_commands()
 {
-  if (!has_screen_changed)
+  if (command_count_ == 0)
   {
     return;
   }
-  has_screen_changed = false;
+  optimize_commands();
+  // target_ is the whole screen, the commands mark the framebuffer dirty as they are replayed
+  rasterize_commands(target_);
+  command_count_ = 0;
+}
+#endif
+
+/// Two rectangles can only be replaced by their union when it doesn't contain any pixel outside of both
+static bool is_exact_union(const Rect& a, const Rect& b)
+{
+  if (a.contains(b) || b.contains(a))
+  {
+    return true;
+  }
+  const bool same_rows = a.y_start == b.y_start && a.y_end == b.y_end;
+  const bool same_cols = a.x_start == b.x_start && a.x_end == b.x_end;
+  return (same_rows && a.x_start <= b.x_end && b.x_start <= a.x_end) ||
+         (same_cols && a.y_start <= b.y_end && b.y_start <= a.y_end);
+}
+
+/// Cut the side of `rect` that `cover` spans entirely. Returns true if `rect` changed.
+static bool trim_covered_side(Rect& rect, const Rect& cover)
+{
+  if (cover.y_start <= rect.y_start && cover.y_end >= rect.y_end)
+  {
+    if (cover.x_start <= rect.x_start && cover.x_end > rect.x_start)
+    {
+      rect.x_start = cover.x_end;
+      return true;
+    }
+    if (cover.x_end >= rect.x_end && cover.x_start < rect.x_end)
+    {
+      rect.x_end = cover.x_start;
+      return true;
+    }
+  }
+  if (cover.x_start <= rect.x_start && cover.x_end >= rect.x_end)
+  {
+    if (cover.y_start <= rect.y_start && cover.y_end > rect.y_start)
+    {
+      rect.y_start = cover.y_end;
+      return true;
+    }
+    if (cover.y_end >= rect.y_end && cover.y_start < rect.y_end)
+    {
+      rect.y_end = cover.y_start;
+      return true;
+    }
+  }
+  return false;
+}
+
+void Display::optimize_commands()
+{
+  constexpr Rect culled{.x_start = 0, .y_start = 0, .x_end = 0, .y_end = 0};
+  display_list_stats_.command_count += command_count_;
+  for (uint16_t i = 0; i < command_count_; ++i)
+  {
+    display_list_stats_.recorded_px += commands_[i].bounds.area();
+  }
+
+  // From the back: a command entirely painted over by a later opaque one is dropped. The commands replay their drawing
+  // call, which only the fills can clip, so only them are trimmed when partially painted over.
+  for (uint16_t i = command_count_; i-- > 0;)
+  {
+    DrawCommand& command = commands_[i];
+    bool has_changed = true;
+    while (has_changed && !command.bounds.is_empty())
+    {
+      has_changed = false;
+      for (uint16_t j = i + 1; j < command_count_; ++j)
+      {
+        const DrawCommand& later = commands_[j];
+        if (!later.is_opaque || !later.bounds.intersects(command.bounds))
+        {
+          continue;
+        }
+        if (later.bounds.contains(command.bounds))
+        {
+          command.bounds = culled;
+          break;
+        }
+        if (!command.rasterize && trim_covered_side(command.bounds, later.bounds))
+        {
+          has_changed = true;
+        }
+      }
+    }
+    if (command.bounds.is_empty())
+    {
+      ++display_list_stats_.culled_count;
+    }
+  }
+
+  // Touching fills of the same color become a single fill, when none of the commands between them overlaps it
+  for (uint16_t j = 1; j < command_count_; ++j)
+  {
+    DrawCommand& command = commands_[j];
+    if (command.rasterize || command.bounds.is_empty())
+    {
+      continue;
+    }
+    for (uint16_t i = j; i-- > 0;)
+    {
+      DrawCommand& earlier = commands_[i];
+      if (earlier.bounds.is_empty())
+      {
+        continue;
+      }
+      if (!earlier.rasterize && earlier.value == command.value && is_exact_union(earlier.bounds, command.bounds))
+      {
+        const Rect merged = earlier.bounds.united(command.bounds);
+        bool is_overlapped = false;
+        for (uint16_t k = i + 1; k < j && !is_overlapped; ++k)
+        {
+          is_overlapped = commands_[k].bounds.intersects(merged);
+        }
+        if (!is_overlapped)
+        {
+          command.bounds = merged;
+          earlier.bounds = culled;
+          ++display_list_stats_.merged_count;
+          break;
+        }
+      }
+      if (earlier.bounds.intersects(command.bounds))
+      {
+        break;
+      }
+    }
+  }
+
+  uint16_t kept_count = 0;
+  for (uint16_t i = 0; i < command_count_; ++i)
+  {
+    if (!commands_[i].bounds.is_empty())
+    {
+      display_list_stats_.rasterized_px += commands_[i].bounds.area();
+      commands_[kept_count] = commands_[i];
+      ++kept_count;
+    }
+  }
+  command_count_ = kept_count;
+#ifdef REPORT_DISPLAY_LIST_STATS
+  display_list_stats_.covered_px += covered_area();
+#endif
+}
+
+void Display::rasterize_commands(const Rect& window)
+{
+  is_rasterizing_ = true;
+  for (uint16_t i = 0; i < command_count_; ++i)
+  {
+    const DrawCommand& command = commands_[i];
+    if (!command.bounds.intersects(window))
+    {
+      continue;
+    }
+    if (command.rasterize)
+    {
+      command.rasterize(*this, command);
+    }
+    else
+    {
+      draw_rectangle(
+        command.bounds.x_start, command.bounds.y_start, command.bounds.x_end, command.bounds.y_end, command.value);
+    }
+  }
+  is_rasterizing_ = false;
+}
+
+#ifdef REPORT_DISPLAY_LIST_STATS
+uint32_t Display::covered_area() const
+{
+  // The commands covering a row only change at their top and bottom edges, so the covered columns are computed once
+  // for each slab of rows between two consecutive edges
+  int16_t edges[2 * max_commands];
+  uint16_t edge_count = 0;
+  for (uint16_t i = 0; i < command_count_; ++i)
+  {
+    edges[edge_count++] = static_cast<int16_t>(commands_[i].bounds.y_start);
+    edges[edge_count++] = static_cast<int16_t>(commands_[i].bounds.y_end);
+  }
+  std::sort(edges, edges + edge_count);
+
+  struct Span
+  {
+    int16_t x_start;
+    int16_t x_end;
+  };
+  Span spans[max_commands];
+  uint32_t area = 0;
+  for (uint16_t e = 1; e < edge_count; ++e)
+  {
+    const int16_t y_start = edges[e - 1];
+    const int16_t y_end = edges[e];
+    if (y_start == y_end)
+    {
+      continue;
+    }
+    uint16_t span_count = 0;
+    for (uint16_t i = 0; i < command_count_; ++i)
+    {
+      const Rect& bounds = commands_[i].bounds;
+      if (bounds.y_start <= y_start && bounds.y_end >= y_end)
+      {
+        spans[span_count++] = Span{static_cast<int16_t>(bounds.x_start), static_cast<int16_t>(bounds.x_end)};
+      }
+    }
+    std::sort(spans, spans + span_count, [](const Span& a, const Span& b) { return a.x_start < b.x_start; });
+    int32_t covered_x_end = 0;
+    uint32_t covered_width = 0;
+    for (uint16_t i = 0; i < span_count; ++i)
+    {
+      const int32_t x_start = std::max<int32_t>(spans[i].x_start, covered_x_end);
+      if (spans[i].x_end > x_start)
+      {
+        covered_width += spans[i].x_end - x_start;
+        covered_x_end = spans[i].x_end;
+      }
+    }
+    area += covered_width * (y_end - y_start);
+  }
+  return area;
+}
+
+void Display::report_display_list_stats()
+{
+  const DisplayListStats& stats = display_list_stats_;
+  const uint32_t frame_count = stats.frame_count > 0 ? stats.frame_count : 1;
+  const uint32_t covered_px = stats.covered_px > 0 ? stats.covered_px : 1;
+  Serial.print("Display list: ");
+  Serial.print(static_cast<int>(stats.frame_count));
+  Serial.print(" frames, ");
+  Serial.print(static_cast<int>(stats.command_count));
+  Serial.print(" commands, ");
+  Serial.print(static_cast<int>(stats.culled_count));
+  Serial.print(" culled, ");
+  Serial.print(static_cast<int>(stats.merged_count));
+  Serial.print(" merged, ");
+  Serial.print(static_cast<int>(stats.rasterized_px / frame_count));
+  Serial.print(" of ");
+  Serial.print(static_cast<int>(stats.recorded_px / frame_count));
+  Serial.print(" px/frame rasterized, overdraw ");
+  Serial.print(static_cast<int>(static_cast<uint64_t>(stats.recorded_px) * 100 / covered_px));
+  Serial.print("% -> ");
+  Serial.print(static_cast<int>(static_cast<uint64_t>(stats.rasterized_px) * 100 / covered_px));
+  Serial.println("%");
+  display_list_stats_ = DisplayListStats{};
+}
+#endif
+#endif
+
+#ifdef LCD_DOUBLE_BUFFER
+void Display::sync_back_buffer()
+{
+  for (uint8_t i = 0; i < dirty_rect_count_; ++i)
+  {
+    const Rect& rect = dirty_rects_[i];
+    const uint32_t row_len = rect.width() * 3 / 2;
+    uint32_t offset = (static_cast<uint32_t>(rect.y_start) * LCD_WIDTH + rect.x_start) * 3 / 2;
+    for (int32_t y = rect.y_start; y < rect.y_end; ++y)
+    {
+      memcpy(frame_buffer_ + offset, front_buffer_ + offset, row_len);
+      offset += FRAME_BUFFER_ROW_LEN;
+    }
+  }
+}
+
+void Display::start_next_band_transfer()
+{
+  const Rect& band = push_bands_[push_band_idx_];
+  ++push_band_idx_;
+
+  DEV_SPI_BEGIN_TRANS;
+  set_window(0, band.y_start, LCD_WIDTH, band.y_end);
+  DEV_Digital_Write(pin_out::lcd_chip_select.pin, 0);
+  DEV_Digital_Write(pin_out::lcd_dc.pin, 1);
+  is_async_transfer_running = true;
+  SPI.transferAsync(front_buffer_ + band.y_start * FRAME_BUFFER_ROW_LEN, nullptr, band.height() * FRAME_BUFFER_ROW_LEN);
+}
+
+bool Display::is_push_complete()
+{
+  if (!LCD_poll_async_transfer())
+  {
+    return false;
+  }
+  if (push_band_idx_ < push_band_count_)
+  {
+    start_next_band_transfer();
+    return false;
+  }
+  return true;
+}
+
+bool Display::blip_framebuffer()
+{
+#ifdef LCD_DISPLAY_LIST
+  ++display_list_stats_.frame_count;
+  flush_commands();
+#endif
+  coalesce_dirty_tiles();
+  if (dirty_rect_count_ == 0)
+  {
+    return false;
+  }
+
+  // The DMA must be done reading the front buffer before we swap
+  while (!is_push_complete())
+  {
+  }
+  std::swap(frame_buffer_, front_buffer_);
+  sync_back_buffer();
+
+  // Only full rows are contiguous in memory, turn the dirty regions into bands of rows sorted from top to bottom
+  push_band_count_ = 0;
+  for (uint8_t i = 0; i < dirty_rect_count_; ++i)
+  {
+    Rect band{.x_start = 0, .y_start = dirty_rects_[i].y_start, .x_end = LCD_WIDTH, .y_end = dirty_rects_[i].y_end};
+    uint8_t j = push_band_count_;
+    while (j > 0 && push_bands_[j - 1].y_start > band.y_start)
+    {
+      push_bands_[j] = push_bands_[j - 1];
+      --j;
+    }
+    push_bands_[j] = band;
+    ++push_band_count_;
+  }
+  // Merge overlapping or touching bands
+  uint8_t merged_count = 1;
+  for (uint8_t i = 1; i < push_band_count_; ++i)
+  {
+    Rect& last = push_bands_[merged_count - 1];
+    if (push_bands_[i].y_start <= last.y_end)
+    {
+      last.y_end = std::max(last.y_end, push_bands_[i].y_end);
+      continue;
+    }
+    push_bands_[merged_count] = push_bands_[i];
+    ++merged_count;
+  }
+  push_band_count_ = merged_count;
+  push_band_idx_ = 0;
+  start_next_band_transfer();
+
+  dirty_rect_count_ = 0;
+  return true;
+}
+#elif defined(LCD_BAND_RENDERING)
+bool Display::is_push_complete()
+{
+  return LCD_poll_async_transfer();
+}
+
+bool Display::blip_framebuffer()
+{
+  // The scroll pushes the recorded frame itself
+  if (is_scroll_active())
+  {
+    return false;
+  }
+  ++display_list_stats_.frame_count;
+  const bool has_commands = command_count_ > 0;
+  flush_commands();
+  return has_commands;
+}
+
+void Display::flush_commands()
+{
+  if (command_count_ == 0)
+  {
+    return;
+  }
+  optimize_commands();
+
+  // Only the pixels written by the commands are known, so the windows to push cover exactly the commands' bounds
+  Rect windows[max_commands];
+  uint16_t window_count = 0;
+  for (uint16_t i = 0; i < command_count_; ++i)
+  {
+    windows[window_count] = commands_[i].bounds;
+    ++window_count;
+  }
+  bool has_merged = true;
+  while (has_merged)
+  {
+    has_merged = false;
+    for (uint16_t i = 0; i < window_count; ++i)
+    {
+      for (uint16_t j = i + 1; j < window_count; ++j)
+      {
+        if (is_exact_union(windows[i], windows[j]))
+        {
+          windows[i] = windows[i].united(windows[j]);
+          --window_count;
+          windows[j] = windows[window_count];
+          has_merged = true;
+          --j;
+        }
+      }
+    }
+  }
+
+  // Windows can still overlap, the overlapping pixels are rasterized the same way in both and pushed twice
+  for (uint16_t i = 0; i < window_count; ++i)
+  {
+    const Rect& window = windows[i];
+    const int32_t rows_per_band = static_cast<int32_t>(band_buffer_px / window.width());
+    for (int32_t y = window.y_start; y < window.y_end; y += rows_per_band)
+    {
+      rasterize_and_push(Rect{
+        .x_start = window.x_start,
+        .y_start = y,
+        .x_end = window.x_end,
+        .y_end = std::min(y + rows_per_band, window.y_end)});
+    }
+  }
+  command_count_ = 0;
+}
+
+void Display::rasterize_and_push(const Rect& window)
+{
+  // The other band buffer may still be read by the DMA, this one was pushed before it
+  frame_buffer_ = band_buffers_[band_buffer_idx_];
+  band_buffer_idx_ ^= 1;
+  target_ = window;
+  // Pixels left untouched by the commands (e.g. the diagonal of a rounded corner) show the black background instead
+  // of what the buffer held for the previous window
+  fill_packed_pairs(frame_buffer_, (window.area() + 1) / 2, 0, 0, 0);
+
+  rasterize_commands(window);
+
+  LCD_finish_async_transfer();
+  DEV_SPI_BEGIN_TRANS;
+  set_window(window.x_start, window.y_start, window.x_end, window.y_end);
+  DEV_Digital_Write(pin_out::lcd_chip_select.pin, 0);
+  DEV_Digital_Write(pin_out::lcd_dc.pin, 1);
+  is_async_transfer_running = true;
+  // An odd number of pixels ends with half a byte, the screen ignores the incomplete pixel
+  SPI.transferAsync(frame_buffer_, nullptr, (window.area() * 3 + 1) / 2);
+}
+#else
+bool Display::is_push_complete()
+{
+  return true;
+}
+
+#ifdef LCD_SHADOW_DIFF
+/// Compare 8 pixels (12 bytes) of two framebuffers, 4 bytes at the time
+static inline bool is_chunk_changed(const uint8_t* a, const uint8_t* b)
+{
+  uint32_t a_words[3];
+  uint32_t b_words[3];
+  memcpy(a_words, a, sizeof(a_words));
+  memcpy(b_words, b, sizeof(b_words));
+  return ((a_words[0] ^ b_words[0]) | (a_words[1] ^ b_words[1]) | (a_words[2] ^ b_words[2])) != 0;
+}
+
+void Display::push_changed_runs(const Rect& window)
+{
+  constexpr int32_t chunk_px = 8;
+  constexpr uint32_t chunk_bytes = chunk_px * 3 / 2;
+  // Sending a few unchanged pixels is cheaper than the commands of a new window
+  constexpr int32_t max_gap_chunks = 2;
+
+  // Runs of consecutive rows with the same columns are pushed in the same window
+  Rect pending{.x_start = 0, .y_start = 0, .x_end = 0, .y_end = 0};
+  auto add_run = [&](const Rect& run) {
+    if (run.x_start == pending.x_start && run.x_end == pending.x_end && run.y_start == pending.y_end)
+    {
+      pending.y_end = run.y_end;
+      return;
+    }
+    if (!pending.is_empty())
+    {
+      push_window(pending);
+    }
+    pending = run;
+  };
+
+  for (int32_t y = window.y_start; y < window.y_end; ++y)
+  {
+    const uint32_t row_offset = static_cast<uint32_t>(y) * FRAME_BUFFER_ROW_LEN;
+    int32_t run_start = -1;
+    int32_t run_end = -1;
+    for (int32_t x = window.x_start; x < window.x_end; x += chunk_px)
+    {
+      const uint32_t offset = row_offset + x * 3 / 2;
+      if (!is_chunk_changed(frame_buffer_ + offset, shadow_buffer_ + offset))
+      {
+        continue;
+      }
+      memcpy(shadow_buffer_ + offset, frame_buffer_ + offset, chunk_bytes);
+      if (run_start >= 0 && x - run_end > max_gap_chunks * chunk_px)
+      {
+        add_run(Rect{.x_start = run_start, .y_start = y, .x_end = run_end, .y_end = y + 1});
+        run_start = -1;
+      }
+      if (run_start < 0)
+      {
+        run_start = x;
+      }
+      run_end = x + chunk_px;
+    }
+    if (run_start >= 0)
+    {
+      add_run(Rect{.x_start = run_start, .y_start = y, .x_end = run_end, .y_end = y + 1});
+    }
+  }
+  if (!pending.is_empty())
+  {
+    push_window(pending);
+  }
+}
+#endif
+
+bool Display::blip_framebuffer()
+{
+#ifdef LCD_DISPLAY_LIST
+  ++display_list_stats_.frame_count;
+  flush_commands();
+#endif
+  coalesce_dirty_tiles();
+  if (dirty_rect_count_ == 0)
+  {
+    return false;
+  }
 
   DEV_SPI_BEGIN_TRANS;
-  set_window(0, 0, LCD_WIDTH, LCD_HEIGHT);
+#ifdef LCD_SHADOW_DIFF
+  ++push_stats_.frame_count;
+  for (uint8_t i = 0; i < dirty_rect_count_; ++i)
+  {
+    push_stats_.dirty_bytes += dirty_rects_[i].area() * 3 / 2;
+    if (is_shadow_valid_)
+    {
+      push_changed_runs(dirty_rects_[i]);
+    }
+    else
+    {
+      push_window(dirty_rects_[i]);
+    }
+  }
+  if (!is_shadow_valid_)
+  {
+    memcpy(shadow_buffer_, frame_buffer_, FRAME_BUFFER_LEN);
+    is_shadow_valid_ = true;
+  }
+#else
+  for (uint8_t i = 0; i < dirty_rect_count_; ++i)
+  {
+    push_window(dirty_rects_[i]);
+  }
+#endif
+  DEV_SPI_END_TRANS;
+  dirty_rect_count_ = 0;
+  return true;
+}
+
+#ifdef LCD_SHADOW_DIFF
+void Display::report_push_stats()
+{
+  Serial.print("Shadow diff: ");
+  Serial.print(static_cast<int>(push_stats_.frame_count));
+  Serial.print(" frames, sent ");
+  Serial.print(static_cast<int>(push_stats_.sent_bytes));
+  Serial.print(" of ");
+  Serial.print(static_cast<int>(push_stats_.dirty_bytes));
+  Serial.print(" dirty bytes, saved ");
+  const uint32_t saved_bytes =
+    push_stats_.dirty_bytes > push_stats_.sent_bytes ? push_stats_.dirty_bytes - push_stats_.sent_bytes : 0;
+  Serial.print(static_cast<int>(push_stats_.frame_count > 0 ? saved_bytes / push_stats_.frame_count : 0));
+  Serial.println(" bytes/frame");
+  push_stats_ = PushStats{};
+}
+#endif
+#endif
+
+#ifndef LCD_BAND_RENDERING
+void Display::push_window(const Rect& rect)
+{
+  set_window(rect.x_start, rect.y_start, rect.x_end, rect.y_end);
   DEV_Digital_Write(pin_out::lcd_chip_select.pin, 0);
   DEV_Digital_Write(pin_out::lcd_dc.pin, 1);
-  SPI.transfer(frame_buffer_, nullptr, FRAME_BUFFER_LEN);
+  const uint32_t row_len = rect.width() * 3 / 2;
+  const uint32_t first_byte = (static_cast<uint32_t>(rect.y_start) * LCD_WIDTH + rect.x_start) * 3 / 2;
+  if (rect.width() == LCD_WIDTH)
+  {
+    // Full width rows are contiguous in the framebuffer
+    SPI.transfer(frame_buffer_ + first_byte, nullptr, row_len * rect.height());
+  }
+  else
+  {
+    for (uint32_t y = 0; y < rect.height(); ++y)
+    {
+      SPI.transfer(frame_buffer_ + first_byte + y * FRAME_BUFFER_ROW_LEN, nullptr, row_len);
+    }
+  }
   DEV_Digital_Write(pin_out::lcd_chip_select.pin, 1);
+#ifdef LCD_SHADOW_DIFF
+  push_stats_.sent_bytes += rect.area() * 3 / 2;
+#endif
+}
+#endif
+
+void Display::set_scroll_offset(const uint16_t offset_px)
+{
+  // MADCTL (MY) reverses the order of the panel lines, moving the content to the left means starting the scroll
+  // area further back in the panel memory
+  const uint16_t start_line = (LCD_WIDTH - offset_px % LCD_WIDTH) % LCD_WIDTH;
+  LCD_finish_async_transfer();
+  DEV_SPI_BEGIN_TRANS;
+  LCD_Write_Command(LCD_REG_VSCSAD);
+  LCD_WriteData_Word(start_line);
+  DEV_SPI_END_TRANS;
+}
+
+void Display::push_scroll_strip(const Rect& strip)
+{
+#ifdef LCD_BAND_RENDERING
+  const int32_t rows_per_band = static_cast<int32_t>(band_buffer_px / strip.width());
+  for (int32_t y = strip.y_start; y < strip.y_end; y += rows_per_band)
+  {
+    rasterize_and_push(Rect{
+      .x_start = strip.x_start,
+      .y_start = y,
+      .x_end = strip.x_end,
+      .y_end = std::min(y + rows_per_band, strip.y_end)});
+  }
+#else
+  DEV_SPI_BEGIN_TRANS;
+  push_window(strip);
   DEV_SPI_END_TRANS;
+#endif
+}
+
+void Display::start_scroll_in(const bool from_right, const uint32_t duration_ms)
+{
+  finish_transition();
+#ifdef LCD_BAND_RENDERING
+  // The commands are kept to rasterize the strips, blip_framebuffer() leaves them alone during the scroll
+  optimize_commands();
+#else
+#ifdef LCD_DISPLAY_LIST
+  flush_commands();
+#endif
+#ifdef LCD_DOUBLE_BUFFER
+  // The strips are sent from the back buffer, the DMA must be done with the front one
+  while (!is_push_complete())
+  {
+  }
+  memcpy(front_buffer_, frame_buffer_, FRAME_BUFFER_LEN);
+#endif
+#ifdef LCD_SHADOW_DIFF
+  memcpy(shadow_buffer_, frame_buffer_, FRAME_BUFFER_LEN);
+  is_shadow_valid_ = true;
+#endif
+  // The frame is pushed by the scroll, nothing is drawn until it's over
+  memset(dirty_tiles_, 0, sizeof(dirty_tiles_));
+#endif
+  transition_type_ = TransitionType::scroll;
+  start_time_ = millis();
+  scroll_from_right_ = from_right;
+  scroll_duration_ms_ = duration_ms;
+  scroll_shown_px_ = 0;
+}
+
+void Display::scroll_to(const int32_t shown_px)
+{
+  if (shown_px == scroll_shown_px_)
+  {
+    return;
+  }
+  // The new columns replace, in the panel memory, the old ones which just scrolled out on the other side. They are
+  // pushed at their own coordinates, so the frame is in place once the offset is back to 0.
+  if (scroll_from_right_)
+  {
+    push_scroll_strip(Rect{.x_start = scroll_shown_px_, .y_start = 0, .x_end = shown_px, .y_end = LCD_HEIGHT});
+    set_scroll_offset(shown_px);
+  }
+  else
+  {
+    push_scroll_strip(Rect{
+      .x_start = static_cast<int32_t>(LCD_WIDTH) - shown_px,
+      .y_start = 0,
+      .x_end = static_cast<int32_t>(LCD_WIDTH) - scroll_shown_px_,
+      .y_end = LCD_HEIGHT});
+    set_scroll_offset(LCD_WIDTH - shown_px);
+  }
+  scroll_shown_px_ = shown_px;
+}
+
+Rect Display::get_clip_rect() const
+{
+  return target_;
+}
+
+void Display::begin_offscreen(Surface& surface)
+{
+  assert(onscreen_buffer_ == nullptr);
+  onscreen_buffer_ = frame_buffer_;
+  onscreen_target_ = target_;
+  frame_buffer_ = surface.data();
+  // An invalid surface has no pixels, everything is clipped away
+  target_ = surface.is_valid() ? surface.bounds() : Rect{.x_end = 0, .y_end = 0};
+#ifdef LCD_DISPLAY_LIST
+  was_rasterizing_ = is_rasterizing_;
+  is_rasterizing_ = true;
+#endif
+}
+
+void Display::end_offscreen()
+{
+  assert(onscreen_buffer_ != nullptr);
+  frame_buffer_ = onscreen_buffer_;
+  target_ = onscreen_target_;
+  onscreen_buffer_ = nullptr;
+#ifdef LCD_DISPLAY_LIST
+  is_rasterizing_ = was_rasterizing_;
+#endif
+}
+
+#ifdef LCD_DISPLAY_LIST
+static void rasterize_surface(Display& display, const DrawCommand& command)
+{
+  display.blit(*static_cast<const Surface*>(command.data), command.x_start, command.y_start);
+}
+#endif
+
+void Display::blit(const Surface& surface, const int32_t offset_x, const int32_t offset_y)
+{
+  if (!surface.is_valid())
+  {
+    return;
+  }
+  const Rect& bounds = surface.bounds();
+  Rect rect{
+    .x_start = bounds.x_start + offset_x,
+    .y_start = bounds.y_start + offset_y,
+    .x_end = bounds.x_end + offset_x,
+    .y_end = bounds.y_end + offset_y};
+  rect.clip_to_screen();
+#ifdef LCD_DISPLAY_LIST
+  if (is_recording())
+  {
+    record_command(DrawCommand{
+      .rasterize = &rasterize_surface, .bounds = rect, .data = &surface, .x_start = offset_x, .y_start = offset_y});
+    return;
+  }
+#endif
+  rect = rect.intersected(target_);
+  if (rect.is_empty())
+  {
+    return;
+  }
+  for (int32_t y = rect.y_start; y < rect.y_end; ++y)
+  {
+    const uint32_t src_x = static_cast<uint32_t>(y - offset_y - bounds.y_start) * bounds.width() +
+                           static_cast<uint32_t>(rect.x_start - offset_x - bounds.x_start);
+    copy_packed_span_unsafe(rect.x_start, y, surface.data(), src_x, rect.width());
+  }
+}
+
+uint32_t Display::pixel_index(const uint16_t x, const uint16_t y) const
+{
+  return (y - target_.y_start) * target_.width() + (x - target_.x_start);
 }
 
 void Display::clear_screen(const uint32_t color_12bit)
 {
+  assert(onscreen_buffer_ == nullptr);
+#ifdef LCD_DISPLAY_LIST
+  record_command(DrawCommand{.bounds = Rect{}, .value = color_12bit});
+#else
   const uint8_t byte0 = (color_12bit >> 4) & 0xff;                                   // 8 MSb
   const uint8_t byte1 = ((color_12bit & 0xf) << 4) | ((color_12bit & 0x0f00) >> 8);  // 4 LSb + 4 MSb
   const uint8_t byte2 = color_12bit & 0xff;                                          // 8 LSb
@@ -270,14 +1221,11 @@ void Display::clear_screen(const uint32_t color_12bit)
   else
   {
     assert(FRAME_BUFFER_LEN % 3 == 0);  // TODO: handle case where the number of pixel is not a multiple of 3
-    for (uint32_t i = 0; i < FRAME_BUFFER_LEN; i += 3)
-    {
-      frame_buffer_[i] = byte0;
-      frame_buffer_[i + 1] = byte1;
-      frame_buffer_[i + 2] = byte2;
-    }
+    fill_packed_pairs(frame_buffer_, FRAME_BUFFER_LEN / 3, byte0, byte1, byte2);
   }
-  has_screen_changed = true;
+  COUNT_PIXEL_WRITES(0, 0, LCD_WIDTH, LCD_HEIGHT);
+  mark_all_dirty();
+#endif
 }
 
 void Display::draw_rectangle(
@@ -306,61 +1254,184 @@ void Display::draw_rectangle(
   // Serial.print(y_end);
   // Serial.println("");
 
+  Rect rect{.x_start = x_start, .y_start = y_start, .x_end = x_end, .y_end = y_end};
+#ifdef LCD_DISPLAY_LIST
+  if (!is_rasterizing_)
+  {
+    record_command(DrawCommand{.bounds = rect, .value = color_12bit});
+    return;
+  }
+#endif
+  rect = rect.intersected(target_);
+  if (rect.is_empty())
+  {
+    return;
+  }
+
+  for (int32_t y = rect.y_start; y < rect.y_end; ++y)
+  {
+    write_fill_span(rect.x_start, y, rect.width(), color_12bit);
+  }
+
+  mark_dirty(rect);
+}
+
+void Display::write_fill_span(const uint16_t x, const uint16_t y, const uint16_t len, const uint32_t color_12bit)
+{
   // Precompute the 3-byte pattern for two identical RGB444 pixels.
   // Even pixel (first in pair):  byte0 = RRRRGGGG, byte1 upper nibble = BBBB
   // Odd pixel  (second in pair): byte1 lower nibble = RRRR, byte2 = GGGGBBBB
   const uint8_t byte_pair_0 = (color_12bit >> 4) & 0xFF;
   const uint8_t byte_pair_1 = ((color_12bit & 0xF) << 4) | ((color_12bit >> 8) & 0xF);
   const uint8_t byte_pair_2 = color_12bit & 0xFF;
+  COUNT_PIXEL_WRITES(x, y, len, 1);
+
+  uint32_t px = pixel_index(x, y);
+  const uint32_t px_end = px + len;
+  uint32_t bo = px * 3 / 2;
 
-  for (uint16_t y = y_start; y < y_end; ++y)
+  // Case 1: leading odd pixel shares a byte with the pixel before the span.
+  if ((px & 1) == 1 && px < px_end)
   {
-    uint32_t px = static_cast<uint32_t>(y) * LCD_WIDTH + x_start;
-    const uint32_t px_end = static_cast<uint32_t>(y) * LCD_WIDTH + x_end;
-    uint32_t bo = px * 3 / 2;
+    frame_buffer_[bo] = (frame_buffer_[bo] & 0xF0) | ((color_12bit >> 8) & 0x0F);
+    frame_buffer_[bo + 1] = byte_pair_2;
+    ++px;
+    bo += 2;
+  }
 
-    // Case 1: leading odd pixel shares a byte with the pixel before the rectangle.
-    if ((px & 1) == 1)
-    {
-      frame_buffer_[bo] = (frame_buffer_[bo] & 0xF0) | ((color_12bit >> 8) & 0x0F);
-      frame_buffer_[bo + 1] = byte_pair_2;
-      ++px;
-      bo = px * 3 / 2;
-    }
+  // Case 2: bulk-write aligned pairs (3 bytes per 2 pixels).
+  const uint32_t pair_count = (px_end - px) / 2;
+  fill_packed_pairs(frame_buffer_ + bo, pair_count, byte_pair_0, byte_pair_1, byte_pair_2);
+  px += pair_count * 2;
+  bo += pair_count * 3;
 
-    // Case 2: bulk-write aligned pairs (3 bytes per 2 pixels).
-    for (; px + 1 < px_end; px += 2)
-    {
-      frame_buffer_[bo] = byte_pair_0;
-      frame_buffer_[bo + 1] = byte_pair_1;
-      frame_buffer_[bo + 2] = byte_pair_2;
-      bo += 3;
-    }
+  // Case 3: trailing even pixel shares a byte with the pixel after the span.
+  if (px < px_end)
+  {
+    frame_buffer_[bo] = byte_pair_0;
+    frame_buffer_[bo + 1] = (frame_buffer_[bo + 1] & 0x0F) | ((color_12bit & 0xF) << 4);
+  }
+}
 
-    // Case 3: trailing even pixel shares a byte with the pixel after the rectangle.
-    if (px < px_end)
+void Display::write_span(const uint16_t x, const uint16_t y, const uint16_t* colors_12bit, const uint16_t len)
+{
+  COUNT_PIXEL_WRITES(x, y, len, 1);
+  uint32_t px = pixel_index(x, y);
+  const uint32_t px_end = px + len;
+  uint32_t bo = px * 3 / 2;
+  const uint16_t* color = colors_12bit;
+
+  // Leading odd pixel: 4 MSb in the low nibble of the first byte, 8 LSb in the next byte
+  if ((px & 1) == 1 && px < px_end)
+  {
+    frame_buffer_[bo] = (frame_buffer_[bo] & 0xF0) | ((color[0] >> 8) & 0x0F);
+    frame_buffer_[bo + 1] = color[0] & 0xFF;
+    ++color;
+    ++px;
+    bo += 2;
+  }
+
+  // Pairs of pixels fill 3 bytes
+  for (; px + 1 < px_end; px += 2)
+  {
+    frame_buffer_[bo] = (color[0] >> 4) & 0xFF;
+    frame_buffer_[bo + 1] = ((color[0] & 0xF) << 4) | ((color[1] >> 8) & 0xF);
+    frame_buffer_[bo + 2] = color[1] & 0xFF;
+    color += 2;
+    bo += 3;
+  }
+
+  // Trailing even pixel: 8 MSb in the first byte, 4 LSb in the high nibble of the next byte
+  if (px < px_end)
+  {
+    frame_buffer_[bo] = (color[0] >> 4) & 0xFF;
+    frame_buffer_[bo + 1] = (frame_buffer_[bo + 1] & 0x0F) | ((color[0] & 0xF) << 4);
+  }
+}
+
+void Display::set_span_unsafe(const uint16_t x, const uint16_t y, const uint16_t* colors_12bit, const uint16_t len)
+{
+#ifdef LCD_DISPLAY_LIST
+  // The colors only live during the drawing call, it must have been recorded instead
+  assert(is_rasterizing_);
+#endif
+  write_span(x, y, colors_12bit, len);
+  mark_dirty(Rect{.x_start = x, .y_start = y, .x_end = x + len, .y_end = y + 1});
+}
+
+void Display::copy_packed_span_unsafe(
+  const uint16_t x, const uint16_t y, const uint8_t* src_row, const uint32_t src_x, const uint16_t len)
+{
+#ifdef LCD_DISPLAY_LIST
+  assert(is_rasterizing_);
+#endif
+  mark_dirty(Rect{.x_start = x, .y_start = y, .x_end = x + len, .y_end = y + 1});
+  uint32_t px = pixel_index(x, y);
+  if (((px ^ src_x) & 1) != 0)
+  {
+    // Every pixel would need to be shifted by a nibble
+    uint16_t row_colors[LCD_WIDTH];
+    for (uint16_t i = 0; i < len; ++i)
     {
-      frame_buffer_[bo] = byte_pair_0;
-      frame_buffer_[bo + 1] = (frame_buffer_[bo + 1] & 0x0F) | ((color_12bit & 0xF) << 4);
+      row_colors[i] = get_packed_pixel(src_row, src_x + i);
     }
+    write_span(x, y, row_colors, len);
+    return;
   }
+  COUNT_PIXEL_WRITES(x, y, len, 1);
 
-  has_screen_changed = true;
+  const uint32_t px_end = px + len;
+  uint32_t bo = px * 3 / 2;
+  const uint8_t* src = src_row + src_x * 3 / 2;
+  // Leading odd pixel, its 4 MSb share a byte with the previous pixel
+  if ((px & 1) == 1 && px < px_end)
+  {
+    frame_buffer_[bo] = (frame_buffer_[bo] & 0xF0) | (src[0] & 0x0F);
+    frame_buffer_[bo + 1] = src[1];
+    ++px;
+    bo += 2;
+    src += 2;
+  }
+  const uint32_t pair_count = (px_end - px) / 2;
+  memcpy(frame_buffer_ + bo, src, pair_count * 3);
+  px += pair_count * 2;
+  bo += pair_count * 3;
+  src += pair_count * 3;
+  // Trailing even pixel, its 4 LSb share a byte with the next pixel
+  if (px < px_end)
+  {
+    frame_buffer_[bo] = src[0];
+    frame_buffer_[bo + 1] = (frame_buffer_[bo + 1] & 0x0F) | (src[1] & 0xF0);
+  }
 }
 
-void Display::set_pixel_unsafe(const uint16_t x, const uint16_t y, const uint32_t color_12bit)
+void Display::fill_span_unsafe(const uint16_t x, const uint16_t y, const uint16_t len, const uint32_t color_12bit)
 {
-#ifdef SIM
-  static int count_px = 0;
-  ++count_px;
-  if (count_px > 500)
+#ifdef LCD_DISPLAY_LIST
+  if (!is_rasterizing_)
+  {
+    record_command(
+      DrawCommand{.bounds = Rect{.x_start = x, .y_start = y, .x_end = x + len, .y_end = y + 1}, .value = color_12bit});
+    return;
+  }
+#endif
+  write_fill_span(x, y, len, color_12bit);
+  mark_dirty(Rect{.x_start = x, .y_start = y, .x_end = x + len, .y_end = y + 1});
+}
+
+void Display::write_pixel(const uint16_t x, const uint16_t y, const uint32_t color_12bit)
+{
+#if defined(SIM) && !defined(BENCH)
+  ++sim_write_count_;
+  if (sim_write_count_ > 500)
   {
     delay(1);
-    count_px = 0;
+    sim_write_count_ = 0;
   }
 #endif
 
-  const uint32_t px_offset = static_cast<uint32_t>(y) * LCD_WIDTH + x;
+  COUNT_PIXEL_WRITES(x, y, 1, 1);
+  const uint32_t px_offset = pixel_index(x, y);
   const uint32_t bytes_offset = px_offset * 3 / 2;
   // Because pixels take 1.5bytes, we need to handle the case where the pixel is at the start of a byte or at the middle
   if ((px_offset & 1) == 0)
@@ -375,126 +1446,200 @@ void Display::set_pixel_unsafe(const uint16_t x, const uint16_t y, const uint32_
       (frame_buffer_[bytes_offset] & 0xf0) | ((color_12bit & 0xf00) >> 8);  // previous pixel's 4 LSb + 4 MSb
     frame_buffer_[bytes_offset + 1] = color_12bit & 0xff;                   // 8 LSb
   }
-  has_screen_changed = true;
+}
+
+void Display::set_pixel_unsafe(const uint16_t x, const uint16_t y, const uint32_t color_12bit)
+{
+#ifdef LCD_DISPLAY_LIST
+  if (!is_rasterizing_)
+  {
+    record_command(
+      DrawCommand{.bounds = Rect{.x_start = x, .y_start = y, .x_end = x + 1, .y_end = y + 1}, .value = color_12bit});
+    return;
+  }
+#endif
+  // Drawing calls which write single pixels aren't clipped to the band or the surface
+  if (!target_.contains(x, y))
+  {
+    return;
+  }
+  write_pixel(x, y, color_12bit);
+  if (onscreen_buffer_ == nullptr)
+  {
+    dirty_tiles_[y / tile_size_px] |= 1u << (x / tile_size_px);
+  }
 }
 
 void Display::checkerboard_dissolve()
 {
+#ifdef LCD_BAND_RENDERING
+  // The previous frame isn't kept
+  return;
+#elif defined(LCD_DISPLAY_LIST)
+  // The pixels are read back, the recorded commands must be in the framebuffer
+  flush_commands();
+#endif
   // Packed 12-bit RGB444: 2 pixels per 3 bytes.
   // Even pixel: byte0 = RRRRGGGG, byte1[7:4] = BBBB
   // Odd pixel:  byte1[3:0] = RRRR, byte2 = GGGGBBBB
   // Black (0x000): all nibbles zero.
+  // Even pixel at (x, y) and odd pixel at (x+1, y) are always opposites, so each row is a single mask repeated
+  // on every pair of pixels.
   for (uint16_t y = 0; y < LCD_HEIGHT; ++y)
   {
-    for (uint16_t x = 0; x < LCD_WIDTH; x += 2)
+    uint8_t* row = frame_buffer_ + static_cast<uint32_t>(y) * FRAME_BUFFER_ROW_LEN;
+    if (y & 1)
     {
-      const uint32_t bo = (static_cast<uint32_t>(y) * LCD_WIDTH + x) * 3 / 2;
-
-      // Even pixel at (x, y) and odd pixel at (x+1, y) are always opposites,
-      // so a single XOR check suffices.
-      if ((x ^ y) & 1)
-      {
-        // Even pixel -> black, preserve odd pixel
-        frame_buffer_[bo] = 0;
-        frame_buffer_[bo + 1] &= 0x0F;
-      }
-      else
-      {
-        // Odd pixel -> black, preserve even pixel
-        frame_buffer_[bo + 1] &= 0xF0;
-        frame_buffer_[bo + 2] = 0;
-      }
+      // Even pixel -> black, preserve odd pixel
+      mask_packed_pairs(row, LCD_WIDTH / 2, 0x00, 0x0F, 0xFF);
+    }
+    else
+    {
+      // Odd pixel -> black, preserve even pixel
+      mask_packed_pairs(row, LCD_WIDTH / 2, 0xFF, 0xF0, 0x00);
     }
   }
-  has_screen_changed = true;
-}
-
-// Fixed-point sin table: Q8.8 format, 256 entries for a full circle.
-// sin_lut[a] = round(256 * sin(2*pi*a/256))
-static const int16_t sin_lut[256] = {
-  0, 6, 13, 19, 25, 31, 38, 44, 50, 56, 62, 68, 74, 80, 86, 92,
-  98, 104, 109, 115, 121, 126, 132, 137, 142, 147, 152, 157, 162, 167, 172, 177,
-  181, 185, 190, 194, 198, 202, 206, 209, 213, 216, 220, 223, 226, 229, 231, 234,
-  237, 239, 241, 243, 245, 247, 248, 250, 251, 252, 253, 254, 255, 255, 256, 256,
-  256, 256, 256, 255, 255, 254, 253, 252, 251, 250, 248, 247, 245, 243, 241, 239,
-  237, 234, 231, 229, 226, 223, 220, 216, 213, 209, 206, 202, 198, 194, 190, 185,
-  181, 177, 172, 167, 162, 157, 152, 147, 142, 137, 132, 126, 121, 115, 109, 104,
-  98, 92, 86, 80, 74, 68, 62, 56, 50, 44, 38, 31, 25, 19, 13, 6,
-  0, -6, -13, -19, -25, -31, -38, -44, -50, -56, -62, -68, -74, -80, -86, -92,
-  -98, -104, -109, -115, -121, -126, -132, -137, -142, -147, -152, -157, -162, -167, -172, -177,
-  -181, -185, -190, -194, -198, -202, -206, -209, -213, -216, -220, -223, -226, -229, -231, -234,
-  -237, -239, -241, -243, -245, -247, -248, -250, -251, -252, -253, -254, -255, -255, -256, -256,
-  -256, -256, -256, -255, -255, -254, -253, -252, -251, -250, -248, -247, -245, -243, -241, -239,
-  -237, -234, -231, -229, -226, -223, -220, -216, -213, -209, -206, -202, -198, -194, -190, -185,
-  -181, -177, -172, -167, -162, -157, -152, -147, -142, -137, -132, -126, -121, -115, -109, -104,
-  -98, -92, -86, -80, -74, -68, -62, -56, -50, -44, -38, -31, -25, -19, -13, -6,
-};
+  COUNT_PIXEL_WRITES(0, 0, LCD_WIDTH, LCD_HEIGHT);
+  mark_all_dirty();
+}
 
+void Display::start_checkerboard_dissolve()
+{
+  finish_transition();
+  checkerboard_dissolve();
+  transition_type_ = TransitionType::checkerboard;
+  transition_frame_ = 0;
+}
 void Display::start_melt()
 {
+  finish_transition();
   transition_type_ = TransitionType::melt;
   transition_frame_ = 0;
   start_time_ = millis();
   memset(melt_front_, 0, sizeof(melt_front_));
 }
-
 void Display::start_roto_zoom()
 {
-  roto_backup_ = static_cast<uint8_t*>(malloc(FRAME_BUFFER_LEN));
+  finish_transition();
+#ifndef LCD_BAND_RENDERING
+#ifdef LCD_DISPLAY_LIST
+  flush_commands();
+#endif
+  // The rotation blurs the old screen anyway, so keeping one pixel out of four is enough
+  roto_backup_ = static_cast<uint8_t*>(malloc(roto_backup_len));
   if (roto_backup_)
   {
-    memcpy(roto_backup_, frame_buffer_, FRAME_BUFFER_LEN);
+    for (uint32_t y = 0; y < roto_backup_height; ++y)
+    {
+      const uint8_t* src = frame_buffer_ + 2 * y * FRAME_BUFFER_ROW_LEN;
+      uint8_t* dst = roto_backup_ + y * roto_backup_row_len;
+      // Keep the even pixel of each pair, i.e. the first 12 bits of each 3 bytes
+      for (uint32_t x = 0; x < roto_backup_width; x += 2, src += 6, dst += 3)
+      {
+        dst[0] = src[0];
+        dst[1] = (src[1] & 0xF0) | (src[3] >> 4);
+        dst[2] = ((src[3] & 0x0F) << 4) | (src[4] >> 4);
+      }
+    }
   }
+#endif
   transition_type_ = TransitionType::roto_zoom;
   transition_frame_ = 0;
   start_time_ = millis();
   rot_angle_ = 0;
+  roto_row_ = 0;
 }
-
-bool Display::advance_transition()
+bool Display::advance_transition(const uint32_t budget_us)
 {
   switch (transition_type_)
   {
+    case TransitionType::checkerboard:
+      // The dissolved frame was drawn by start_checkerboard_dissolve(), it has been pushed by now
+      transition_type_ = TransitionType::none;
+      return true;
     case TransitionType::melt:
       return advance_melt();
     case TransitionType::roto_zoom:
-      return advance_roto_zoom();
+      return advance_roto_zoom(budget_us);
+    case TransitionType::scroll:
+      return advance_scroll();
     default:
       return true;
   }
 }
+void Display::finish_transition()
+{
+  switch (transition_type_)
+  {
+    case TransitionType::melt:
+      // Melt what's left of every strip at once
+      for (uint16_t strip = 0; strip < melt_strip_count; ++strip)
+      {
+        const uint16_t x = strip * melt_strip_width;
+        draw_rectangle(x, melt_front_[strip], x + melt_strip_width, LCD_HEIGHT, 0);
+        melt_front_[strip] = LCD_HEIGHT;
+      }
+      break;
+    case TransitionType::roto_zoom:
+      free(roto_backup_);
+      roto_backup_ = nullptr;
+      break;
+    case TransitionType::scroll:
+      // Push the rest of the new frame in one go
+      scroll_to(LCD_WIDTH);
+#ifdef LCD_BAND_RENDERING
+      command_count_ = 0;
+#endif
+      break;
+    default:
+      break;
+  }
+  transition_type_ = TransitionType::none;
+}
+
+bool Display::advance_scroll()
+{
+  const fixed_t progress = ease_in_out(animation_progress(millis() - start_time_, scroll_duration_ms_));
+  // Steps of whole pixel pairs, the strips start on a byte of the packed framebuffer
+  scroll_to(lerp(0, LCD_WIDTH, progress) & ~1);
+  if (scroll_shown_px_ < static_cast<int32_t>(LCD_WIDTH))
+  {
+    return false;
+  }
+  finish_transition();
+  return true;
+}
 
 bool Display::advance_melt()
 {
   constexpr uint32_t MELT_DURATION_MS = 500;
   constexpr uint8_t MAX_FRAMES = 12;
+  static_assert(LCD_WIDTH % melt_strip_width == 0);
+#ifdef LCD_DISPLAY_LIST
+  static_assert(melt_strip_count <= max_commands, "A step of the melt must fit in the display list");
+#endif
   bool all_done = true;
   const uint32_t elapsed = millis() - start_time_;
-  float progress = static_cast<float>(elapsed) / static_cast<float>(MELT_DURATION_MS);
-  const uint8_t current_frame =  static_cast<uint8_t>(MAX_FRAMES * progress);
+  const uint8_t current_frame = static_cast<uint8_t>(lerp(0, MAX_FRAMES, animation_progress(elapsed, MELT_DURATION_MS)));
 
-  for (int x = 0; x < LCD_WIDTH; ++x)
+  for (uint16_t strip = 0; strip < melt_strip_count; ++strip)
   {
-    if (melt_front_[x] < LCD_HEIGHT)
+    if (melt_front_[strip] < LCD_HEIGHT)
     {
       all_done = false;
-      int advance = 8 + current_frame * 2 * (2000/MELT_DURATION_MS) + ((x * 7) % 12);
-      uint8_t prev = melt_front_[x];
-      uint8_t next = prev + advance;
+      int advance = 8 + current_frame * 2 * (2000/MELT_DURATION_MS) + ((strip * 7) % 12);
+      const int prev = melt_front_[strip];
+      int next = prev + advance;
       if (next > LCD_HEIGHT)
       {
         next = LCD_HEIGHT;
       }
-      melt_front_[x] = next;
-      for (uint8_t y = prev; y < next; ++y)
-      {
-        set_pixel_unsafe(x, y, 0);
-      }
+      melt_front_[strip] = static_cast<uint8_t>(next);
+      const uint16_t x = strip * melt_strip_width;
+      draw_rectangle(x, prev, x + melt_strip_width, next, 0);
     }
   }
 
-  has_screen_changed = true;
-
   if (all_done || current_frame >= MAX_FRAMES)
   {
     transition_type_ = TransitionType::none;
@@ -503,7 +1648,7 @@ bool Display::advance_melt()
   return false;
 }
 
-bool Display::advance_roto_zoom()
+bool Display::advance_roto_zoom(const uint32_t budget_us)
 {
   constexpr uint8_t MAX_FRAMES = 6;
 
@@ -518,32 +1663,53 @@ bool Display::advance_roto_zoom()
   int16_t cos_val = sin_lut[(rot_angle_ + 64) & 0xFF];
   int16_t sin_val = -sin_lut[rot_angle_];
 
-  for (int dy = 0; dy < LCD_HEIGHT; ++dy)
+  // A whole frame doesn't fit in the budget, render as many rows as we can and resume on the next call
+  const unsigned long start_us = micros();
+  const int first_row = roto_row_;
+  uint16_t row_colors[LCD_WIDTH];
+  while (roto_row_ < LCD_HEIGHT && micros() - start_us < budget_us)
   {
-    for (int dx = 0; dx < LCD_WIDTH; ++dx)
+    const int dy = roto_row_++;
+    // Source position in 8 bit fixed point, stepped incrementally along the destination row
+    const int ry = dy - LCD_HEIGHT / 2;
+    int sx_fp = -(LCD_WIDTH / 2) * cos_val - ry * sin_val + (LCD_WIDTH / 2 << 8);
+    int sy_fp = -(LCD_WIDTH / 2) * sin_val + ry * cos_val + (LCD_HEIGHT / 2 << 8);
+    // Pixels rotated from outside of the screen are kept as is, so the row is written by runs of visible pixels
+    int run_start = -1;
+    for (int dx = 0; dx < LCD_WIDTH; ++dx, sx_fp += cos_val, sy_fp += sin_val)
     {
-      int rx = dx - LCD_WIDTH / 2;
-      int ry = dy - LCD_HEIGHT / 2;
-
-      int sx = ((rx * cos_val - ry * sin_val) >> 8) + LCD_WIDTH / 2;
-      int sy = ((rx * sin_val + ry * cos_val) >> 8) + LCD_HEIGHT / 2;
-
-      if (sx >= 0 && sx < LCD_WIDTH && sy >= 0 && sy < LCD_HEIGHT)
+      if (
+        static_cast<uint32_t>(sx_fp) < (static_cast<uint32_t>(LCD_WIDTH) << 8) &&
+        static_cast<uint32_t>(sy_fp) < (static_cast<uint32_t>(LCD_HEIGHT) << 8))
       {
-        uint32_t bo = (static_cast<uint32_t>(sy) * LCD_WIDTH + sx) * 3 / 2;
-        uint16_t color;
-        if (sx & 1)
-          color = ((roto_backup_[bo + 1] & 0x0F) << 8) | roto_backup_[bo + 2];
-        else
-          color = (roto_backup_[bo] << 4) | ((roto_backup_[bo + 1] >> 4) & 0x0F);
-        set_pixel_unsafe(dx, dy, color);
+        // >> 9: from 8 bit fixed point to the half resolution snapshot
+        row_colors[dx] = get_packed_pixel(roto_backup_ + (sy_fp >> 9) * roto_backup_row_len, sx_fp >> 9);
+        if (run_start < 0)
+        {
+          run_start = dx;
+        }
       }
+      else if (run_start >= 0)
+      {
+        write_span(run_start, dy, row_colors + run_start, dx - run_start);
+        run_start = -1;
+      }
+    }
+    if (run_start >= 0)
+    {
+      write_span(run_start, dy, row_colors + run_start, LCD_WIDTH - run_start);
     }
   }
+  mark_dirty(Rect{.x_start = 0, .y_start = first_row, .x_end = LCD_WIDTH, .y_end = roto_row_});
+
+  if (roto_row_ < LCD_HEIGHT)
+  {
+    return false;
+  }
 
+  roto_row_ = 0;
   ++transition_frame_;
   rot_angle_ += 21;  // ~30° per frame, ~360° total over 12 frames
-  has_screen_changed = true;
 
   if (transition_frame_ >= MAX_FRAMES)
   {
@@ -49,6 +49,41 @@
 
 #define LCD_BACKLIGHT 57  // Between 0-256 for 0 to 100% brightness
 
+// Push the framebuffer with DMA while the next frame is drawn in a second framebuffer, blip_framebuffer() then returns
+// right away instead of blocking for the whole SPI transfer. Costs another 115KB of RAM (out of 264KB).
+// #define LCD_DOUBLE_BUFFER
+
+// Keep a copy of the last frame sent to the screen and only push the pixels which actually changed inside the dirty
+// regions. Useful when views redraw without checking if anything changed. Costs another 115KB of RAM.
+// #define LCD_SHADOW_DIFF
+
+#if defined(LCD_DOUBLE_BUFFER) && defined(LCD_SHADOW_DIFF)
+#error "LCD_SHADOW_DIFF sends many small windows, which isn't supported by the DMA push of LCD_DOUBLE_BUFFER"
+#endif
+
+// Don't keep a framebuffer: the drawing calls of a frame are recorded and rasterized by blip_framebuffer() into two
+// small band buffers, one being pushed by DMA while the next one is rasterized. Saves ~100KB of RAM, but the
+// transitions which read back the previous frame (checkerboard dissolve, roto-zoom) only leave the screen as is.
+// #define LCD_BAND_RENDERING
+
+#if defined(LCD_BAND_RENDERING) && (defined(LCD_DOUBLE_BUFFER) || defined(LCD_SHADOW_DIFF))
+#error "LCD_BAND_RENDERING has no framebuffer, it can't be combined with LCD_DOUBLE_BUFFER or LCD_SHADOW_DIFF"
+#endif
+
+// Record the drawing calls of a frame in a display list instead of drawing them right away. blip_framebuffer() drops
+// the commands entirely painted over by later ones, trims and merges the fills, then rasterizes what's left into the
+// framebuffer. Saves the clears followed by text or images, see REPORT_DISPLAY_LIST_STATS.
+// #define LCD_DISPLAY_LIST
+
+// Print every second the overdraw of the display list, before and after its optimization. Finding the pixels covered
+// by the commands of each frame is slow, only do it when the report is wanted.
+// #define REPORT_DISPLAY_LIST_STATS
+
+#ifdef LCD_BAND_RENDERING
+// The bands are rasterized from the display list
+#define LCD_DISPLAY_LIST
+#endif
+
 #define LCD_WIDTH 320   // LCD width
 #define LCD_HEIGHT 240  // LCD height
 
@@ -59,6 +94,8 @@
 #define LCD_REG_COL_ADDR_SET 0x2a
 #define LCD_REG_ROW_ADDR_SET 0x2b
 #define LCD_REG_MEM_WRITE 0x2C
+#define LCD_REG_VSCRDEF 0x33  // Vertical scrolling definition
+#define LCD_REG_VSCSAD 0x37   // Vertical scroll start address
 
 /**
  * GPIO read and write
@@ -78,7 +115,140 @@
  **/
 #define DEV_Set_PWM(_Value) analogWrite(pin_out::lcd_backlight.pin, _Value)
 
+/**
+ * Globals of the driver: the simulator can run an instance of the app per thread, the device has a single one
+ **/
+#ifdef SIM
+#define DEV_THREAD_LOCAL thread_local
+#else
+#define DEV_THREAD_LOCAL
+#endif
+
 #define FRAME_BUFFER_LEN (LCD_WIDTH * LCD_HEIGHT * 3 / 2)
+#define FRAME_BUFFER_ROW_LEN (LCD_WIDTH * 3 / 2)
+
+/// Read the pixel x of a row of packed RGB444 pixels (2 pixels in 3 bytes)
+inline uint16_t get_packed_pixel(const uint8_t* row, const uint32_t x)
+{
+  const uint32_t bo = x * 3 / 2;
+  if (x & 1)
+  {
+    return ((row[bo] & 0x0F) << 8) | row[bo + 1];
+  }
+  return (row[bo] << 4) | ((row[bo + 1] >> 4) & 0x0F);
+}
+
+/// Block until the on-going asynchronous push to the screen (if any) is done and the SPI bus is released.
+/// The IO expanders share the SPI bus with the screen, so they must call this before talking to the bus.
+void LCD_finish_async_transfer();
+
+// Lightweight rectangle for clipping. Uses exclusive-end (x_end,y_end is first pixel outside).
+// All methods should be inlined by the compiler with any optimization level.
+struct Rect
+{
+  int32_t x_start{0};  // left, inclusive
+  int32_t y_start{0};  // top, inclusive
+  int32_t x_end{LCD_WIDTH};  // right, exclusive
+  int32_t y_end{LCD_HEIGHT};  // bottom, exclusive
+
+  void clip_to_screen()
+  {
+    if (x_start < 0)
+    {
+      x_start = 0;
+    }
+    if (y_start < 0)
+    {
+      y_start = 0;
+    }
+    if (x_end > static_cast<int32_t>(LCD_WIDTH))
+    {
+      x_end = static_cast<int32_t>(LCD_WIDTH);
+    }
+    if (y_end > static_cast<int32_t>(LCD_HEIGHT))
+    {
+      y_end = static_cast<int32_t>(LCD_HEIGHT);
+    }
+  }
+
+  inline bool is_empty() const
+  {
+    return x_start >= x_end || y_start >= y_end;
+  }
+  inline uint32_t width() const
+  {
+    return static_cast<uint32_t>(x_end - x_start);
+  }
+  inline uint32_t height() const
+  {
+    return static_cast<uint32_t>(y_end - y_start);
+  }
+  inline uint32_t area() const
+  {
+    return is_empty() ? 0 : width() * height();
+  }
+  inline bool contains(const int32_t x, const int32_t y) const
+  {
+    return x >= x_start && x < x_end && y >= y_start && y < y_end;
+  }
+  inline bool contains(const Rect& other) const
+  {
+    return other.x_start >= x_start && other.x_end <= x_end && other.y_start >= y_start && other.y_end <= y_end;
+  }
+  inline bool intersects(const Rect& other) const
+  {
+    return other.x_start < x_end && x_start < other.x_end && other.y_start < y_end && y_start < other.y_end;
+  }
+  // Smallest rectangle containing both rectangles
+  inline Rect united(const Rect& other) const
+  {
+    return Rect{
+      .x_start = x_start < other.x_start ? x_start : other.x_start,
+      .y_start = y_start < other.y_start ? y_start : other.y_start,
+      .x_end = x_end > other.x_end ? x_end : other.x_end,
+      .y_end = y_end > other.y_end ? y_end : other.y_end};
+  }
+  // Part of the rectangle inside the other one, empty when they don't intersect
+  inline Rect intersected(const Rect& other) const
+  {
+    return Rect{
+      .x_start = x_start > other.x_start ? x_start : other.x_start,
+      .y_start = y_start > other.y_start ? y_start : other.y_start,
+      .x_end = x_end < other.x_end ? x_end : other.x_end,
+      .y_end = y_end < other.y_end ? y_end : other.y_end};
+  }
+};
+
+class Surface;
+
+#ifdef LCD_DISPLAY_LIST
+class Display;
+
+/// A recorded drawing call, replayed when the display list is rasterized (once for each band it covers with
+/// LCD_BAND_RENDERING)
+struct DrawCommand
+{
+  /// Draw the command again, the display clips it to the band being rasterized. Null for a plain fill of `bounds`
+  /// with the color `value`.
+  void (*rasterize)(Display& display, const DrawCommand& command){nullptr};
+  /// Pixels the command may write, it's clipped to them
+  Rect bounds;
+  /// Glyph or image to draw
+  const void* data{nullptr};
+  /// Coordinates as given to the drawing call, before clipping
+  int32_t x_start{0};
+  int32_t y_start{0};
+  int32_t x_end{0};
+  int32_t y_end{0};
+  /// Color or radius
+  uint32_t value{0};
+  /// Boolean options of the drawing call
+  uint8_t flags{0};
+  /// Every pixel of `bounds` is written, whatever was there before, so earlier commands it covers can be dropped
+  bool is_opaque{true};
+};
+#endif
+
 
 class Display
 {
@@ -87,7 +257,27 @@ public:
   void init();
   void set_backlight(uint16_t value);
 
-  void blip_framebuffer();
+  /// Push the regions of the framebuffer that changed since the last push. Each dirty region is sent in its own
+  /// window, so a small change (e.g. a few digits) doesn't cost a full frame on the SPI bus.
+  /// With LCD_DOUBLE_BUFFER, the push is done by DMA in the background, this only waits for the previous push.
+  /// Returns false when nothing changed since the last push.
+  bool blip_framebuffer();
+  /// Returns true when the last push is entirely on the screen. Must be polled regularly with LCD_DOUBLE_BUFFER as it
+  /// also starts the DMA transfer of the next dirty region.
+  bool is_push_complete();
+
+#ifdef LCD_SHADOW_DIFF
+  struct PushStats
+  {
+    uint32_t frame_count{0};
+    // Bytes in the dirty regions, what would be sent without the shadow diff
+    uint32_t dirty_bytes{0};
+    // Bytes of pixels actually sent
+    uint32_t sent_bytes{0};
+  };
+  /// Print the amount of bytes saved by the shadow diff since the last report
+  void report_push_stats();
+#endif
 
   void clear_screen(const uint32_t color_12bit);
   void draw_rectangle(
@@ -98,38 +288,225 @@ public:
     const uint32_t color_12bit);
   void set_pixel(const uint16_t x, const uint16_t y, const uint32_t color_12bit);
   void set_pixel_unsafe(const uint16_t x, const uint16_t y, const uint32_t color_12bit);
+  /// Write a row of `len` pixels starting at (x, y). The whole span must be on the screen.
+  void set_span_unsafe(const uint16_t x, const uint16_t y, const uint16_t* colors_12bit, const uint16_t len);
+  /// Copy `len` pixels of a packed RGB444 row starting at its pixel src_x to (x, y). The bytes are copied as is when
+  /// both have the same pixel parity. The whole span must be on the screen.
+  void copy_packed_span_unsafe(
+    const uint16_t x, const uint16_t y, const uint8_t* src_row, const uint32_t src_x, const uint16_t len);
+  /// Fill a row of `len` pixels starting at (x, y) with one color. The whole span must be on the screen.
+  void fill_span_unsafe(const uint16_t x, const uint16_t y, const uint16_t len, const uint32_t color_12bit);
+  /// Region the *_unsafe() calls may write to: the whole screen, the band being rasterized with LCD_BAND_RENDERING or
+  /// the surface being drawn
+  Rect get_clip_rect() const;
 
-  /// Replace every other pixel with black (checkerboard pattern) for a dissolve transition.
-  /// Operates directly on the framebuffer for maximum speed.
-  void checkerboard_dissolve();
+  /// Send the drawing calls to `surface` instead of the screen until end_offscreen(). They are drawn right away, even
+  /// with LCD_DISPLAY_LIST, and clipped to the surface. clear_screen() only works on the screen, see Surface::fill().
+  void begin_offscreen(Surface& surface);
+  void end_offscreen();
+  /// Copy the surface to the screen, moved by (offset_x, offset_y) from its bounds. With LCD_DISPLAY_LIST the surface
+  /// must live until the next blip_framebuffer().
+  void blit(const Surface& surface, const int32_t offset_x, const int32_t offset_y = 0);
 
-  /// Start a vertical melt transition. Call advance_transition() each frame until it returns true.
+#ifdef LCD_DISPLAY_LIST
+  /// True when the drawing calls must be recorded with record_command(), false while the display list is rasterized
+  bool is_recording() const { return !is_rasterizing_; }
+  /// Add a drawing call to the current frame
+  void record_command(const DrawCommand& command);
+
+  struct DisplayListStats
+  {
+    uint32_t frame_count{0};
+    uint32_t command_count{0};
+    // Commands dropped because later ones paint over them, and fills merged into a touching one
+    uint32_t culled_count{0};
+    uint32_t merged_count{0};
+    // Pixels of the commands as recorded and once optimized, pixels of the screen they cover
+    uint32_t recorded_px{0};
+    uint32_t rasterized_px{0};
+    uint32_t covered_px{0};
+  };
+#ifdef REPORT_DISPLAY_LIST_STATS
+  /// Print the overdraw of the frames since the last report, before and after the optimization of the display list
+  void report_display_list_stats();
+#endif
+#endif
+
+  /// Show the panel memory moved `offset_px` columns to the left, wrapping around, without sending any pixel. The
+  /// panel is scanned along our x axis, so its "vertical" scroll moves the content horizontally.
+  void set_scroll_offset(const uint16_t offset_px);
+  /// Start sliding the frame drawn since the last push in from the right (or the left) edge over `duration_ms`,
+  /// pushing the old frame out. Only the columns exposed at each step are sent, the scroll moves the rest, and the new
+  /// frame is on the screen once the transition is over.
+  void start_scroll_in(const bool from_right, const uint32_t duration_ms);
+
+  /// Start a checkerboard dissolve transition: every other pixel is replaced with black and the transition is over
+  /// once that frame has been pushed to the screen.
+  void start_checkerboard_dissolve();
+  /// Start a vertical melt transition.
   void start_melt();
   /// Start a roto-zoom transition (spins the old screen into a vortex).
   void start_roto_zoom();
-  /// Advance the active transition by one frame. Returns true when the transition is complete.
-  bool advance_transition();
+  /// Advance the active transition by one step, meant to be called once per tick. Steps bigger than `budget_us` are
+  /// spread over several calls. Returns true when the transition is complete.
+  bool advance_transition(const uint32_t budget_us = transition_budget_us);
+  /// Jump to the end of the active transition, e.g. when the user interacts with the device during it.
+  void finish_transition();
   /// Returns true if a transition is currently running.
   bool is_transition_active() const { return transition_type_ != TransitionType::none; }
+  /// Returns true during start_scroll_in(), which leaves the new frame on the screen instead of the views drawing it
+  bool is_scroll_active() const { return transition_type_ == TransitionType::scroll; }
+
+  /// Default time spent per tick on a transition, so the inputs and relays keep being serviced while it runs
+  static constexpr uint32_t transition_budget_us = 4000;
 
 private:
-  enum class TransitionType : uint8_t { none, melt, roto_zoom };
+  enum class TransitionType : uint8_t { none, checkerboard, melt, roto_zoom, scroll };
 
   TransitionType transition_type_{TransitionType::none};
   uint8_t transition_frame_{0};
   unsigned long start_time_{0};
-  uint8_t melt_front_[LCD_WIDTH];
+  /// The melt moves strips of columns together, so a step is a few fills which fit in the display list
+  static constexpr uint16_t melt_strip_width = 4;
+  static constexpr uint16_t melt_strip_count = LCD_WIDTH / melt_strip_width;
+  uint8_t melt_front_[melt_strip_count];
+  // Half resolution snapshot of the screen sampled by the roto-zoom, a quarter of the framebuffer's memory
   uint8_t* roto_backup_{nullptr};
+  static constexpr uint16_t roto_backup_width = LCD_WIDTH / 2;
+  static constexpr uint16_t roto_backup_height = LCD_HEIGHT / 2;
+  static constexpr uint32_t roto_backup_row_len = roto_backup_width * 3 / 2;
+  static constexpr uint32_t roto_backup_len = roto_backup_row_len * roto_backup_height;
   uint8_t rot_angle_{0};
+  // Next row of the current roto-zoom frame to render
+  uint16_t roto_row_{0};
+  bool scroll_from_right_{false};
+  uint32_t scroll_duration_ms_{0};
+  // Columns of the new frame already on the screen
+  int32_t scroll_shown_px_{0};
 
+  /// Replace every other pixel with black (checkerboard pattern).
+  /// Operates directly on the framebuffer for maximum speed.
+  void checkerboard_dissolve();
   bool advance_melt();
-  bool advance_roto_zoom();
+  bool advance_roto_zoom(const uint32_t budget_us);
+  bool advance_scroll();
+  /// Push the columns of the new frame up to `shown_px` and scroll them in
+  void scroll_to(const int32_t shown_px);
 
 private:
   void set_window(const uint16_t x_start, const uint16_t y_start, const uint16_t x_end, const uint16_t y_end);
+  /// Index of the pixel (x, y) in frame_buffer_
+  uint32_t pixel_index(const uint16_t x, const uint16_t y) const;
+  /// Write a pixel in the framebuffer without recording it as dirty, the caller is responsible of calling mark_dirty()
+  void write_pixel(const uint16_t x, const uint16_t y, const uint32_t color_12bit);
+  /// Same as write_pixel() for a row of pixels, the odd/even pixel packing is only handled at both ends of the span
+  void write_span(const uint16_t x, const uint16_t y, const uint16_t* colors_12bit, const uint16_t len);
+  void write_fill_span(const uint16_t x, const uint16_t y, const uint16_t len, const uint32_t color_12bit);
+  /// Record that a region of the framebuffer needs to be pushed to the screen on the next blip_framebuffer().
+  void mark_dirty(const Rect& rect);
+  void mark_all_dirty();
+  /// Turn the dirty tiles into the windows to push (dirty_rects_) and clear the tiles.
+  void coalesce_dirty_tiles();
+  void add_dirty_window(const Rect& span);
+  /// Push the columns of the new frame exposed by a step of the scroll
+  void push_scroll_strip(const Rect& strip);
+
+  /// The screen is split in tiles of 16x16 px, a tile is pushed entirely when any of its pixels changed. Marking a
+  /// pixel dirty is then a single OR, whatever the amount of regions that changed.
+  static constexpr uint32_t tile_size_px = 16;
+  static constexpr uint32_t tile_cols = LCD_WIDTH / tile_size_px;
+  static constexpr uint32_t tile_rows = LCD_HEIGHT / tile_size_px;
+  /// One bit per tile, bit i of a row is the tile column i
+  uint32_t dirty_tiles_[tile_rows] = {0};
 
-  uint8_t frame_buffer_[FRAME_BUFFER_LEN] = {0};
-  bool has_screen_changed{true};
+  /// Maximum number of windows pushed in one blip. When there are more, a window is grown to include the others.
+  static constexpr uint8_t max_dirty_rects = 8;
+  /// Sending a new window cost ~11 bytes of commands, plus the chip select toggling. Two windows are merged if the
+  /// merged window isn't more than this amount of pixels larger than the two windows.
+  static constexpr uint32_t window_overhead_px = 64;
+  /// Windows to push, built from the dirty tiles by coalesce_dirty_tiles()
+  Rect dirty_rects_[max_dirty_rects];
+  uint8_t dirty_rect_count_{0};
+
+#ifdef LCD_DOUBLE_BUFFER
+  /// Copy the dirty regions of the front buffer into the back buffer, so the back buffer is up to date
+  void sync_back_buffer();
+  void start_next_band_transfer();
+
+  alignas(4) uint8_t frame_buffers_[2][FRAME_BUFFER_LEN] = {{0}};
+  /// Back buffer, where everything is drawn
+  uint8_t* frame_buffer_{frame_buffers_[0]};
+  /// Front buffer, read by the DMA
+  uint8_t* front_buffer_{frame_buffers_[1]};
+  /// Rows of the front buffer still to push. A DMA transfer can only read contiguous memory, so each dirty region is
+  /// extended to full width rows.
+  Rect push_bands_[max_dirty_rects];
+  uint8_t push_band_count_{0};
+  uint8_t push_band_idx_{0};
+#elif defined(LCD_BAND_RENDERING)
+  /// Rasterize the commands covering the window into the next band buffer and push it by DMA
+  void rasterize_and_push(const Rect& window);
+
+  /// A band buffer holds 16 full rows, narrower windows get more rows
+  static constexpr uint32_t band_buffer_px = LCD_WIDTH * 16;
+  alignas(4) uint8_t band_buffers_[2][band_buffer_px * 3 / 2];
+  uint8_t band_buffer_idx_{0};
+  /// Band buffer being rasterized, its rows are `target_.width()` pixels long
+  uint8_t* frame_buffer_{band_buffers_[0]};
+#else
+  alignas(4) uint8_t screen_buffer_[FRAME_BUFFER_LEN] = {0};
+  /// Buffer being drawn, screen_buffer_ or a surface
+  uint8_t* frame_buffer_{screen_buffer_};
+#endif
+#ifndef LCD_BAND_RENDERING
+  /// Send a window of frame_buffer_ to the screen, blocking
+  void push_window(const Rect& rect);
+#endif
+
+  /// Region of the screen held by frame_buffer_: the whole screen, the band being rasterized with LCD_BAND_RENDERING
+  /// or the surface being drawn
+  Rect target_;
+  /// Screen state saved by begin_offscreen(), onscreen_buffer_ is null when drawing to the screen
+  uint8_t* onscreen_buffer_{nullptr};
+  Rect onscreen_target_;
+#if defined(SIM) && !defined(BENCH)
+  /// Pixels written one by one since the last pause, the simulator pauses regularly to be as slow as the device
+  uint16_t sim_write_count_{0};
+#endif
+
+#ifdef LCD_DISPLAY_LIST
+  /// Optimize and rasterize the recorded commands (and push them with LCD_BAND_RENDERING), then start a new list
+  void flush_commands();
+  /// Drop the commands painted over by later opaque ones, trim the fills partially painted over and merge the
+  /// touching fills of the same color
+  void optimize_commands();
+  /// Replay the commands intersecting the window into frame_buffer_
+  void rasterize_commands(const Rect& window);
+#ifdef REPORT_DISPLAY_LIST_STATS
+  /// Pixels of the screen covered by at least one command
+  uint32_t covered_area() const;
+#endif
+
+  /// Commands recorded since the last flush, a full list is flushed early
+  static constexpr uint16_t max_commands = 128;
+  DrawCommand commands_[max_commands];
+  uint16_t command_count_{0};
+  bool is_rasterizing_{false};
+  /// is_rasterizing_ before begin_offscreen(), restored by end_offscreen()
+  bool was_rasterizing_{false};
+  DisplayListStats display_list_stats_;
+#endif
+
+#ifdef LCD_SHADOW_DIFF
+  /// Push only the runs of pixels of the window that differ from the shadow buffer, and update the shadow buffer
+  void push_changed_runs(const Rect& window);
+
+  /// Copy of what is on the screen
+  uint8_t shadow_buffer_[FRAME_BUFFER_LEN];
+  /// The screen content is unknown until the first push
+  bool is_shadow_valid_{false};
+  PushStats push_stats_;
+#endif
 };
 
 #endif
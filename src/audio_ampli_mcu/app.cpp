@@ -8,8 +8,23 @@
 #include "dm_sans_extrabold.h"
 
 #include "dm_sans_regular_40.h"
+#include "fixed_point.h"
+#include "tick_profiler.h"
 
-#include <math.h>
+#ifdef SIM
+#include "sim/overdraw_profiler.h"
+#include "sim/spi_bus_model.h"
+#endif
+
+namespace
+{
+// The glyph tables are built at compile time, so they stay in flash instead of RAM
+constexpr LvFontWrapper digit_droid_sans_font(&digit_font_droid_sans_mono_130, true);  // droid_sans_mono
+constexpr LvFontWrapper digit_light_font(&dmsans_36pt_light, true);
+constexpr LvFontWrapper regular_bold_font(&dmsans_36pt_extrabold);
+constexpr LvFontWrapper regular_medium_font(&dmsans_36pt_regular_40);
+constexpr LvFontWrapper regular_large_font(&dm_sans_bold_62);
+}  // namespace
 
 App::App()
   : volume_encoder_(pin_out::volume_encoder_b.pin)
@@ -36,11 +51,12 @@ App::App()
   , volume_ctrl_(state_machine_, persistent_data_, volume_encoder_, gpio_handler_)
   , option_ctrl_(state_machine_, persistent_data_, volume_ctrl_, gpio_handler_)
   , display_{}
-  , digit_droid_sans_font_(&digit_font_droid_sans_mono_130, true) // droid_sans_mono
-  , digit_light_font_(&dmsans_36pt_light, true)
-  , regular_bold_font_(&dmsans_36pt_extrabold)
-  , regular_medium_font_(&dmsans_36pt_regular_40)
-  , regular_large_font_(&dm_sans_bold_62)
+  , frame_scheduler_{}
+  , digit_droid_sans_font_(digit_droid_sans_font)
+  , digit_light_font_(digit_light_font)
+  , regular_bold_font_(regular_bold_font)
+  , regular_medium_font_(regular_medium_font)
+  , regular_large_font_(regular_large_font)
   , main_menu_view_(option_ctrl_, volume_ctrl_, persistent_data_, state_machine_, regular_bold_font_, digit_droid_sans_font_, regular_medium_font_)
   , option_view_(option_ctrl_, volume_ctrl_, persistent_data_, state_machine_, regular_bold_font_, regular_medium_font_, regular_large_font_)
   , standby_view_(state_machine_, display_, regular_bold_font_, cat_sleep_image)
@@ -133,111 +149,170 @@ void App::update_low_power_timer()
       return;
   }
 
-  static std::optional<unsigned long> maybe_timer;
-  static bool prev_power_detected = true;
-
   const bool is_power_detected = digitalRead(pin_out::power_detect.pin) == HIGH;
 
   // Detected -> not detected
-  if (!is_power_detected && prev_power_detected)
+  if (!is_power_detected && prev_power_detected_)
   {
     Serial.println("Starting inactive timer...");
-    maybe_timer.emplace(millis());
+    maybe_inactivity_timer_.emplace(millis());
   } // not detected -> not detected
-  else if (!is_power_detected && !prev_power_detected)
+  else if (!is_power_detected && !prev_power_detected_)
   {
-    if (maybe_timer.has_value() && (millis() - maybe_timer.value()) > threshold_ms)
+    if (maybe_inactivity_timer_.has_value() && (millis() - maybe_inactivity_timer_.value()) > threshold_ms)
     {
       Serial.println("Turning off...");
       option_view_.power_off();
       state_machine_.change_state(State::standby);
-      maybe_timer = std::nullopt;
+      maybe_inactivity_timer_ = std::nullopt;
     }
   } // not detected -> detected
-  else if (is_power_detected && !prev_power_detected)
+  else if (is_power_detected && !prev_power_detected_)
   {
     Serial.println("End inactive timer...");
-    maybe_timer = std::nullopt;
+    maybe_inactivity_timer_ = std::nullopt;
   }
 
-  prev_power_detected = is_power_detected;
+  prev_power_detected_ = is_power_detected;
 #endif
 }
 
 void App::tick()
 {
-  remote_ctrl_.decode_command();
-  interaction_handler_.update();
+#ifdef SIM
+  overdraw_begin_view("App");
+#endif
+  // Keep the background push to the screen going
+  display_.is_push_complete();
+  PROFILE_TICK_BEGIN(TickStage::decode_command);
+  bool has_input = remote_ctrl_.decode_command();
+  PROFILE_TICK_END(TickStage::decode_command);
+  PROFILE_TICK_BEGIN(TickStage::interaction);
+  has_input |= interaction_handler_.update();
+  PROFILE_TICK_END(TickStage::interaction);
+  PROFILE_TICK_BEGIN(TickStage::volume);
   volume_ctrl_.update();
+  PROFILE_TICK_END(TickStage::volume);
+
+  // Any input cuts a running transition short, so the screen reacts right away
+  if (display_.is_transition_active() && has_input)
+  {
+    // The scroll leaves the new frame on the screen, the views draw again after the other transitions
+    is_redraw_pending_ |= !display_.is_scroll_active();
+    display_.finish_transition();
+  }
 
-  bool has_state_changed = state_machine_.update();
-  if (has_state_changed)
+  if (state_machine_.update())
   {
     Serial.println("state changed!");
     // On first init, no animation
-    static bool init = true;
-    if (!init)
+    if (!is_first_state_change_)
     {
       display_.start_melt();
-      while(!display_.advance_transition())
-      {
-        display_.blip_framebuffer();
-      }
-      display_.blip_framebuffer();
     }
-    init = false;
-    display_.clear_screen(BLACK_COLOR);
-    has_state_changed = true;
-  }
-
-
-  switch (state_machine_.get_state())
-  {
-    case State::main_menu:
-      main_menu_view_.draw(display_, has_state_changed);
-      break;
-    case State::option_menu:
-      option_view_.draw(display_, has_state_changed);
-      break;
-    case State::standby:
-      standby_view_.draw(has_state_changed);
-      break;
+    is_first_state_change_ = false;
+    is_redraw_pending_ = true;
   }
 
   update_low_power_timer();
 
+  PROFILE_TICK_BEGIN(TickStage::flash_save);
   persistent_data_flasher_.save(persistent_data_);
-  display_.blip_framebuffer();
-}
+  PROFILE_TICK_END(TickStage::flash_save);
 
+  // The inputs and relays above are serviced on every tick, the frames only at the frame rate
+  if (frame_scheduler_.begin_frame(display_.is_push_complete()))
+  {
+    draw_frame();
+  }
 
+#ifdef LCD_SHADOW_DIFF
+  if (millis() - last_push_report_ms_ > 1000)
+  {
+    display_.report_push_stats();
+    last_push_report_ms_ = millis();
+  }
+#endif
+#if defined(LCD_DISPLAY_LIST) && defined(REPORT_DISPLAY_LIST_STATS)
+  if (millis() - last_display_list_report_ms_ > 1000)
+  {
+    display_.report_display_list_stats();
+    last_display_list_report_ms_ = millis();
+  }
+#endif
+#ifdef REPORT_FRAME_STATS
+  if (millis() - last_frame_report_ms_ > 1000)
+  {
+    frame_scheduler_.report_frame_stats();
+    last_frame_report_ms_ = millis();
+  }
+#endif
+  PROFILE_TICK_POLL_REPORT();
+#ifdef SIM
+  spi_bus_end_tick();
+#endif
+}
 
-void App::test_draw_speed()
+void App::draw_frame()
 {
-  const auto N = 10;
-  display_.clear_screen(BLACK_COLOR);
-  const auto start = millis();
-  for (int i = 0; i < N; ++i)
+  // The transition runs one step per frame, the previous step has reached the screen
+  bool has_scrolled = false;
+  if (display_.is_transition_active())
+  {
+    has_scrolled = display_.is_scroll_active();
+    display_.advance_transition();
+    is_redraw_pending_ |= !has_scrolled && !display_.is_transition_active();
+  }
+
+  if (!display_.is_transition_active())
   {
-    for (uint16_t y = 0; y < LCD_HEIGHT; ++y)
+    PROFILE_TICK_BEGIN(TickStage::draw);
+    // The views draw from scratch after a transition
+    const bool has_state_changed = is_redraw_pending_;
+    if (has_state_changed)
     {
-      for (uint16_t x = 0; x < LCD_WIDTH; ++x)
-      {
-        display_.set_pixel(x, y, (x ^ y) % 9 == 0 ? WHITE_COLOR : BLACK_COLOR);
-      }
+      display_.clear_screen(BLACK_COLOR);
     }
+    is_redraw_pending_ = false;
 
-    // LCD_Clear_12bitRGB_async(i % 2 == 0 ? BLACK_COLOR : WHITE_COLOR);
-    display_.blip_framebuffer();
+    switch (state_machine_.get_state())
+    {
+      case State::main_menu:
+#ifdef SIM
+        overdraw_begin_view("MainMenuView");
+#endif
+        main_menu_view_.draw(display_, has_state_changed);
+        break;
+      case State::option_menu:
+#ifdef SIM
+        overdraw_begin_view("OptionsView");
+#endif
+        option_view_.draw(display_, has_state_changed);
+        break;
+      case State::standby:
+#ifdef SIM
+        overdraw_begin_view("StandbyView");
+#endif
+        standby_view_.draw(has_state_changed);
+        break;
+    }
+    PROFILE_TICK_END(TickStage::draw);
   }
-  const auto end = millis();
-  Serial.print("Took total: ");
-  Serial.print(end - start);
-  Serial.print("ms or ");
-  Serial.print(static_cast<float>(end - start) / static_cast<float>(N));
-  Serial.println("ms/frame");
+
+  frame_scheduler_.begin_push();
+  PROFILE_TICK_BEGIN(TickStage::blip);
+  // The scroll sends its columns as it advances
+  const bool has_pushed = display_.blip_framebuffer() || has_scrolled;
+  PROFILE_TICK_END(TickStage::blip);
+  frame_scheduler_.end_frame(has_pushed);
+#ifdef SIM
+  overdraw_end_frame();
+  spi_bus_end_frame();
+#endif
 }
 
+
+
 void App::test_clear_rectangle()
 {
   const auto N = 5;
@@ -267,16 +342,20 @@ void App::test_clear_rectangle()
 /// to prove that set_pixel_unsafe is never called with out-of-bounds coordinates.
 void App::test_bounds_check()
 {
-  static uint32_t frame = 0;
-  ++frame;
-
-  const float t = frame * 0.02f;
+  // 0.02 rad per frame, in turns
+  constexpr fixed_t frame_angle = float_to_fixed(0.02f / 6.2831853f);
+  // Frequencies of the image's vertical motion and of the centered text, relative to the horizontal motion
+  constexpr fixed_t image_y_freq = float_to_fixed(1.3f);
+  constexpr fixed_t center_text_freq = float_to_fixed(0.7f);
+
+  const uint32_t frame = ++test_bounds_frame_;
+  const fixed_t t = static_cast<fixed_t>(frame) * frame_angle;
   display_.clear_screen(BLACK_COLOR);
 
   // --- 1. Image: wide ellipse, goes off ALL edges ---
   {
-    const int32_t cx = static_cast<int32_t>(sinf(t) * (LCD_WIDTH * 0.65f));
-    const int32_t cy = static_cast<int32_t>(cosf(t * 1.3f) * (LCD_HEIGHT * 0.65f));
+    const int32_t cx = fixed_to_int(fixed_sin(t) * (LCD_WIDTH * 65 / 100));
+    const int32_t cy = fixed_to_int(fixed_cos(fixed_mul(t, image_y_freq)) * (LCD_HEIGHT * 65 / 100));
     const int32_t img_x = LCD_WIDTH / 2 + cx - static_cast<int32_t>(cat_sleep_image.w_px / 2);
     const int32_t img_y = LCD_HEIGHT / 2 + cy - static_cast<int32_t>(cat_sleep_image.h_px / 2);
     draw_image_from_top_left(display_, cat_sleep_image, img_x, img_y);
@@ -305,7 +384,7 @@ void App::test_bounds_check()
 
   // --- 5. Centered text: oscillates past left & right edges ---
   {
-    const int32_t offset = static_cast<int32_t>(sinf(t * 0.7f) * (LCD_WIDTH * 0.55f));
+    const int32_t offset = fixed_to_int(fixed_sin(fixed_mul(t, center_text_freq)) * (LCD_WIDTH * 55 / 100));
     const int32_t box_cx = LCD_WIDTH / 2 + offset;
     draw_string_fast(display_, "CENTER", box_cx, LCD_HEIGHT / 2 - 20, box_cx + 160, regular_bold_font_, true, false, TextAlign::center);
   }
@@ -3,6 +3,7 @@
 
 #include "LCD_Driver.h"
 #include "config.h"
+#include "frame_scheduler.h"
 #include "gpio_handler.h"
 #include "interaction_handler.h"
 #include "io_expander.h"
@@ -13,6 +14,7 @@
 #include "remote_controller.h"
 #include "standby_view.h"
 #include "state_machine.h"
+#include "tick_profiler.h"
 #include "volume_controller.h"
 
 #ifdef SIM
@@ -21,6 +23,7 @@
 #include "pio_encoder.h"
 #endif
 
+#include <optional>
 #include <vector>
 
 /// Top-level application class that owns all subsystems.
@@ -38,9 +41,10 @@ public:
 
 private:
   void update_low_power_timer();
+  /// Advance the transition or let the current view draw, then push the frame
+  void draw_frame();
 
 
-  void test_draw_speed();
   void test_clear_rectangle();
   void test_bounds_check();
 
@@ -67,11 +71,14 @@ private:
 
   // --- Display / fonts ---
   Display display_;
-  LvFontWrapper digit_droid_sans_font_;
-  LvFontWrapper digit_light_font_;
-  LvFontWrapper regular_bold_font_;
-  LvFontWrapper regular_medium_font_;
-  LvFontWrapper regular_large_font_;
+  FrameScheduler frame_scheduler_;
+  /// The views must draw from scratch on the next frame, after a state change or a transition
+  bool is_redraw_pending_{false};
+  const LvFontWrapper& digit_droid_sans_font_;
+  const LvFontWrapper& digit_light_font_;
+  const LvFontWrapper& regular_bold_font_;
+  const LvFontWrapper& regular_medium_font_;
+  const LvFontWrapper& regular_large_font_;
 
   // --- Views ---
   MainMenuView main_menu_view_;
@@ -81,6 +88,28 @@ private:
   // --- Input ---
   InteractionHandler interaction_handler_;
   RemoteController remote_ctrl_;
+
+  // --- Tick state ---
+  /// No transition on the first state change, the screen is drawn for the first time
+  bool is_first_state_change_{true};
+#ifdef USE_V2_PCB
+  /// Since when the power is not detected
+  std::optional<unsigned long> maybe_inactivity_timer_;
+  bool prev_power_detected_{true};
+#endif
+#ifdef LCD_SHADOW_DIFF
+  unsigned long last_push_report_ms_{0};
+#endif
+#if defined(LCD_DISPLAY_LIST) && defined(REPORT_DISPLAY_LIST_STATS)
+  unsigned long last_display_list_report_ms_{0};
+#endif
+#ifdef REPORT_FRAME_STATS
+  unsigned long last_frame_report_ms_{0};
+#endif
+#ifdef PROFILE_TICK
+  TickProfiler tick_profiler_;
+#endif
+  uint32_t test_bounds_frame_{0};
 };
 
 #endif  // APP_GUARD_H_
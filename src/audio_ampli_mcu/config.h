@@ -44,4 +44,10 @@
 
 #define BUTTON_DEBOUNCE_DELAY 20  // [ms]
 
+// Print every second the frames drawn and dropped, and the time spent drawing and pushing them
+// #define REPORT_FRAME_STATS
+
+// Time the stages of each tick, see tick_profiler.h. Send 'p' over Serial for a report.
+// #define PROFILE_TICK
+
 #endif  // CONFIG_OPTION_GUARD_H_
@@ -2065,7 +2065,7 @@ static const uint8_t dmsans_36pt_light_glyph_bitmap[] =
 
 
 /*Store the glyph descriptions*/
-static const lv_font_glyph_dsc_t dmsans_36pt_light_glyph_dsc[] = 
+static constexpr lv_font_glyph_dsc_t dmsans_36pt_light_glyph_dsc[] = 
 {
   {.w_px = 57,	.glyph_index = 0},	/*Unicode: U+002d (-) big one*/
   {.w_px = 86,	.glyph_index = 4872},	/*Unicode: U+0030 (0)*/
@@ -2082,7 +2082,7 @@ static const lv_font_glyph_dsc_t dmsans_36pt_light_glyph_dsc[] =
 };
 
 /*List of unicode characters*/
-static const uint32_t dmsans_36pt_light_unicode_list[] = {
+static constexpr uint32_t dmsans_36pt_light_unicode_list[] = {
   44,	/*ignore*/
   48,	/*Unicode: U+0030 (0)*/
   49,	/*Unicode: U+0031 (1)*/
@@ -2098,7 +2098,7 @@ static const uint32_t dmsans_36pt_light_unicode_list[] = {
   0,    /*End indicator*/
 };
 
-lv_font_t dmsans_36pt_light = 
+constexpr lv_font_t dmsans_36pt_light = 
 {
     .h_top_skip_px = 29,
     .h_bot_skip_px = 29,
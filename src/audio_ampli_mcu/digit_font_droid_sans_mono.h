@@ -1896,7 +1896,7 @@ static const uint8_t droid_sans_mono_glyph_bitmap[] =
 
 
 /*Store the glyph descriptions*/
-static const lv_font_glyph_dsc_t droid_sans_mono_glyph_dsc[] = 
+static constexpr lv_font_glyph_dsc_t droid_sans_mono_glyph_dsc[] = 
 {
   {.w_px = 43,	.glyph_index = 0},	/*Unicode: U+002d (-)*/
   {.w_px = 66,	.glyph_index = 4032 - 336},	/*Unicode: U+0030 (0)*/
@@ -1912,7 +1912,7 @@ static const lv_font_glyph_dsc_t droid_sans_mono_glyph_dsc[] =
 };
 
 /*List of unicode characters*/
-static const uint32_t droid_sans_mono_unicode_list[] = {
+static constexpr uint32_t droid_sans_mono_unicode_list[] = {
   45,	/*Unicode: U+002d (-)*/
   48,	/*Unicode: U+0030 (0)*/
   49,	/*Unicode: U+0031 (1)*/
@@ -1927,7 +1927,7 @@ static const uint32_t droid_sans_mono_unicode_list[] = {
   0,    /*End indicator*/
 };
 
-lv_font_t droid_sans_mono = 
+constexpr lv_font_t droid_sans_mono = 
 {
     .h_top_skip_px = 29,
     .h_bot_skip_px = 29,
@@ -3504,7 +3504,7 @@ static const uint8_t digit_font_droid_sans_mono_130_glyph_bitmap[] = {
 
 
 
-static const lv_font_fmt_txt_glyph_dsc_t digit_font_droid_sans_mono_130_glyph_dsc[] = {
+static constexpr lv_font_fmt_txt_glyph_dsc_t digit_font_droid_sans_mono_130_glyph_dsc[] = {
     {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */,
     {.bitmap_index = 0, .adv_w = 42*16, .box_w = 42, .box_h = 11, .ofs_x = 5, .ofs_y = 30},
     {.bitmap_index = 231, .adv_w = 1248 - 120, .box_w = 60, .box_h = 96, .ofs_x = 9, .ofs_y = -1},
@@ -3521,12 +3521,12 @@ static const lv_font_fmt_txt_glyph_dsc_t digit_font_droid_sans_mono_130_glyph_ds
 
 
 
-static const uint8_t digit_font_droid_sans_mono_130_glyph_id_ofs_list_0[] = {
+static constexpr uint8_t digit_font_droid_sans_mono_130_glyph_id_ofs_list_0[] = {
     0, 0, 0, 1, 2, 3, 4, 5,
     6, 7, 8, 9, 10
 };
 
-lv_font_t digit_font_droid_sans_mono_130 = {
+constexpr lv_font_t digit_font_droid_sans_mono_130 = {
   .h_top_skip_px = 0,
   .h_bot_skip_px = 0,
   .spacing_px = 1,
@@ -1897,7 +1897,7 @@ static const uint8_t lt_superior_mono_glyph_bitmap[] =
 
 
 /*Store the glyph descriptions*/
-static const lv_font_glyph_dsc_t lt_superior_mono_glyph_dsc[] = 
+static constexpr lv_font_glyph_dsc_t lt_superior_mono_glyph_dsc[] = 
 {
   {.w_px = 59 - 14,	.glyph_index = 0},	/*Unicode: U+002d (-)*/
   {.w_px = 77,	.glyph_index = 5040 - 1176},	/*Unicode: U+0030 (0)*/  // 60 * 168 / 2 = 5040  now 23 * 168 = 3864 -> 5040 -  3864 = 1176
@@ -1913,7 +1913,7 @@ static const lv_font_glyph_dsc_t lt_superior_mono_glyph_dsc[] =
 };
 
 /*List of unicode characters*/
-static const uint32_t lt_superior_mono_unicode_list[] = {
+static constexpr uint32_t lt_superior_mono_unicode_list[] = {
   45,	/*Unicode: U+002d (-)*/
   48,	/*Unicode: U+0030 (0)*/
   49,	/*Unicode: U+0031 (1)*/
@@ -1928,7 +1928,7 @@ static const uint32_t lt_superior_mono_unicode_list[] = {
   0,    /*End indicator*/
 };
 
-lv_font_t lt_superior_mono = 
+constexpr lv_font_t lt_superior_mono = 
 {
     .h_top_skip_px = 29,
     .h_bot_skip_px = 29,
@@ -7616,7 +7616,7 @@ static const uint8_t dm_sans_bold_62_glyph_bitmap[] = {
 
 
 
-static const lv_font_fmt_txt_glyph_dsc_t dm_sans_bold_62_glyph_dsc[] = {
+static constexpr lv_font_fmt_txt_glyph_dsc_t dm_sans_bold_62_glyph_dsc[] = {
     {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */,
     {.bitmap_index = 0, .adv_w = 206, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0},
     {.bitmap_index = 0, .adv_w = 250, .box_w = 11, .box_h = 44, .ofs_x = 2, .ofs_y = 0},
@@ -7717,7 +7717,7 @@ static const lv_font_fmt_txt_glyph_dsc_t dm_sans_bold_62_glyph_dsc[] = {
 
 
 
-lv_font_t dm_sans_bold_62 = {
+constexpr lv_font_t dm_sans_bold_62 = {
   .h_top_skip_px = 0,
   .h_bot_skip_px = 0,
   .spacing_px = 1,
@@ -3241,7 +3241,7 @@ static const uint8_t dmsans_36pt_extrabold_glyph_bitmap[] =
 
 
 /*Store the glyph descriptions*/
-static const lv_font_glyph_dsc_t dmsans_36pt_extrabold_glyph_dsc[] = 
+static constexpr lv_font_glyph_dsc_t dmsans_36pt_extrabold_glyph_dsc[] = 
 {
   {.w_px = 8,	.glyph_index = 0},	/*Unicode: U+0020 ( )*/
   {.w_px = 6,	.glyph_index = 124},	/*Unicode: U+0021 (!)*/
@@ -3340,7 +3340,7 @@ static const lv_font_glyph_dsc_t dmsans_36pt_extrabold_glyph_dsc[] =
   {.w_px = 14,	.glyph_index = 19530},	/*Unicode: U+007e (~)*/
 };
 
-lv_font_t dmsans_36pt_extrabold = 
+constexpr lv_font_t dmsans_36pt_extrabold = 
 {
     .h_top_skip_px = 5,
     .h_bot_skip_px = 6,
@@ -2988,7 +2988,7 @@ static const uint8_t dmsans_36pt_regular_40_glyph_bitmap[] = {
  *  GLYPH DESCRIPTION
  *--------------------*/
 
-static const lv_font_fmt_txt_glyph_dsc_t dmsans_36pt_regular_40_glyph_dsc[] = {
+static constexpr lv_font_fmt_txt_glyph_dsc_t dmsans_36pt_regular_40_glyph_dsc[] = {
   {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */,
   {.bitmap_index = 0, .adv_w = 138, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0},
   {.bitmap_index = 0, .adv_w = 126, .box_w = 6, .box_h = 28, .ofs_x = 1, .ofs_y = 0},
@@ -4439,7 +4439,7 @@ static const lv_font_fmt_txt_glyph_dsc_t dmsans_36pt_regular_40_glyph_dsc[] = {
 //     .dsc = &font_dsc           /*The custom font data. Will be accessed by `get_glyph_bitmap/dsc` */
 // };
 
-lv_font_t dmsans_36pt_regular_40 = {
+constexpr lv_font_t dmsans_36pt_regular_40 = {
   .h_top_skip_px = 0,
   .h_bot_skip_px = 0,
   .spacing_px = 1,
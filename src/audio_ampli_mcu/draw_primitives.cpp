@@ -15,6 +15,42 @@
 #endif
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 
+/// Fill a lookup table from a glyph's 4 bit alpha to the RGB444 color drawn on screen
+static void build_glyph_color_lut(uint16_t (&lut)[16], const bool is_white_on_black, const uint32_t color)
+{
+  for (uint32_t alpha = 0; alpha < 16; ++alpha)
+  {
+    const uint32_t intensity = is_white_on_black ? alpha : 0xf - alpha;
+    if (color != WHITE_COLOR)
+    {
+      // Blend glyph grayscale with tint color. color is 12-bit RGB444.
+      const uint32_t r = ((color >> 8) & 0xf) * intensity;
+      const uint32_t g = ((color >> 4) & 0xf) * intensity;
+      const uint32_t b = (color & 0xf) * intensity;
+      lut[alpha] = static_cast<uint16_t>(((r / 0xf) << 8) | ((g / 0xf) << 4) | (b / 0xf));
+    }
+    else
+    {
+      // Convert 4bit grayscale to four 4bit RGB
+      lut[alpha] = static_cast<uint16_t>(intensity << 8 | intensity << 4 | intensity);
+    }
+  }
+}
+
+#ifdef LCD_DISPLAY_LIST
+static void rasterize_character(Display& display, const DrawCommand& command)
+{
+  draw_character_fast(
+    display,
+    static_cast<const LvFontWrapper::LvGlyph*>(command.data),
+    command.x_start,
+    command.y_start,
+    command.flags & 1,
+    command.flags & 2,
+    command.value);
+}
+#endif
+
 void draw_character_fast(
   Display& display,
   const LvFontWrapper::LvGlyph* glyph,
@@ -36,10 +72,6 @@ void draw_character_fast(
     return;
   }
 
-  // When the glyph is partially off-screen on the left/top, offset into the glyph bitmap
-  const uint32_t glyph_x_offset = static_cast<uint32_t>(rect.x_start - static_cast<int32_t>(start_x));
-  const uint32_t glyph_y_offset = static_cast<uint32_t>(rect.y_start - static_cast<int32_t>(start_y));
-
   // Make sure that we have an even number of columns, that way we don't have to worry about write call with only one
   // column
   if (rect.width() % 2 != 0)
@@ -52,34 +84,94 @@ void draw_character_fast(
     }
   }
 
-  const auto width = rect.width();
-  const auto height = rect.height();
-  for (uint32_t y = 0; y < height; ++y)
+#ifdef LCD_DISPLAY_LIST
+  if (display.is_recording())
   {
-    uint32_t rgb444_color = 0;
-    for (uint32_t x = 0; x < width; ++x)
+    display.record_command(DrawCommand{
+      .rasterize = &rasterize_character,
+      .bounds = rect,
+      .data = glyph,
+      .x_start = start_x,
+      .y_start = start_y,
+      .value = color,
+      .flags = static_cast<uint8_t>((is_white_on_black ? 1 : 0) | (draw_spacing ? 2 : 0))});
+    return;
+  }
+#endif
+  rect = rect.intersected(display.get_clip_rect());
+  if (rect.is_empty())
+  {
+    return;
+  }
+
+  // When the glyph is partially off-screen on the left/top, offset into the glyph bitmap
+  const uint32_t glyph_x_offset = static_cast<uint32_t>(rect.x_start - static_cast<int32_t>(start_x));
+  const uint32_t glyph_y_offset = static_cast<uint32_t>(rect.y_start - static_cast<int32_t>(start_y));
+
+  // Columns of the glyph covered by the bitmap's bounding box, everything else is transparent
+  const uint32_t left_offset_px = (glyph->width_px - glyph->bitmap_width_px) / 2;
+  const uint32_t box_start_x = left_offset_px + glyph->ofs_x;
+  const uint32_t box_end_x = MIN(box_start_x + glyph->box_w, left_offset_px + glyph->bitmap_width_px);
+
+  // Columns of the glyph to draw
+  const uint32_t draw_start_x = glyph_x_offset;
+  const uint32_t draw_end_x = glyph_x_offset + rect.width();
+  const uint32_t draw_box_start_x = MIN(MAX(box_start_x, draw_start_x), draw_end_x);
+  const uint32_t draw_box_end_x = MAX(MIN(box_end_x, draw_end_x), draw_box_start_x);
+
+  uint16_t color_lut[16];
+  build_glyph_color_lut(color_lut, is_white_on_black, color);
+  const uint32_t transparent_color = color_lut[0];
+  uint16_t row_colors[LCD_WIDTH];
+  for (uint32_t y = 0; y < rect.height(); ++y)
+  {
+    const auto screen_y = static_cast<uint16_t>(rect.y_start + y);
+    const uint32_t glyph_y = y + glyph_y_offset;
+    const uint32_t bitmap_y = glyph_y + glyph->skip_top_px;
+    if (glyph_y >= glyph->height_px || bitmap_y < glyph->ofs_y || bitmap_y >= glyph->ofs_y + glyph->box_h ||
+        draw_box_start_x == draw_box_end_x)
+    {
+      display.fill_span_unsafe(static_cast<uint16_t>(rect.x_start), screen_y, rect.width(), transparent_color);
+      continue;
+    }
+
+    // Left margin
+    if (draw_start_x < draw_box_start_x)
     {
-      auto color_4bit = glyph->get_color(x + glyph_x_offset, y + glyph_y_offset);
-        if (!is_white_on_black)
-        {
-          color_4bit = 0xf - (color_4bit & 0xf);
-        }
-        if (color != WHITE_COLOR)
-        {
-          // Blend glyph grayscale with tint color. color is 12-bit RGB444.
-          const uint32_t glyph_alpha = color_4bit;  // 0-15
-          const uint32_t inv_alpha = 0xf - glyph_alpha;
-          const uint32_t r = ((color >> 8) & 0xf) * glyph_alpha + inv_alpha * 0;
-          const uint32_t g = ((color >> 4) & 0xf) * glyph_alpha + inv_alpha * 0;
-          const uint32_t b = (color & 0xf) * glyph_alpha + inv_alpha * 0;
-          rgb444_color = ((r / 0xf) << 8) | ((g / 0xf) << 4) | (b / 0xf);
-        }
-        else
-        {
-          // Convert 4bit grayscale to four 4bit RGB
-          rgb444_color = (color_4bit << 8 | color_4bit << 4 | color_4bit);
-        }
-        display.set_pixel_unsafe(static_cast<uint16_t>(rect.x_start + x), static_cast<uint16_t>(rect.y_start + y), rgb444_color);
+      display.fill_span_unsafe(
+        static_cast<uint16_t>(rect.x_start), screen_y, draw_box_start_x - draw_start_x, transparent_color);
+    }
+
+    // Decode the bounding box's row sequentially, 2 pixels per byte
+    const uint32_t offset_px = glyph->box_w * (bitmap_y - glyph->ofs_y) + (draw_box_start_x - box_start_x);
+    const uint8_t* src = glyph->raw_bytes + offset_px / 2;
+    const uint32_t box_width = draw_box_end_x - draw_box_start_x;
+    uint32_t x = 0;
+    if (offset_px % 2 != 0)
+    {
+      row_colors[x++] = color_lut[*src++ & 0x0F];
+    }
+    for (; x + 1 < box_width; x += 2)
+    {
+      const uint8_t two_pixels = *src++;
+      row_colors[x] = color_lut[two_pixels >> 4];
+      row_colors[x + 1] = color_lut[two_pixels & 0x0F];
+    }
+    if (x < box_width)
+    {
+      row_colors[x] = color_lut[*src >> 4];
+    }
+    display.set_span_unsafe(
+      static_cast<uint16_t>(rect.x_start + draw_box_start_x - draw_start_x), screen_y, row_colors, box_width);
+
+    // Right margin
+    if (draw_box_end_x < draw_end_x)
+    {
+      display.fill_span_unsafe(
+        static_cast<uint16_t>(rect.x_start + draw_box_end_x - draw_start_x),
+        screen_y,
+        draw_end_x - draw_box_end_x,
+        transparent_color);
     }
   }
 
@@ -147,6 +239,27 @@ void draw_multilines_string(
   }
 }
 
+uint32_t get_string_width_px(const char* str, const LvFontWrapper& font)
+{
+  if (str == NULL || *str == '\0')
+  {
+    return 0;
+  }
+  uint32_t text_width_px = 0;
+  const char* str_temp = str;
+  while (*str_temp != '\0')
+  {
+    if (const auto maybe_glyph = font.get_glyph(*str_temp); maybe_glyph)
+    {
+      text_width_px += maybe_glyph.value()->width_px;
+    }
+    ++str_temp;
+  }
+  text_width_px +=
+    (strlen(str) - 1) * font.get_spacing_px();  // This kind of assumes that every character in string has a glyph
+  return text_width_px;
+}
+
 void draw_string_fast(
   Display& display,
   const char* str,
@@ -167,18 +280,7 @@ void draw_string_fast(
   {
     return;
   }
-  uint32_t text_width_px = 0;
-  const char* str_temp = str;
-  while (*str_temp != '\0')
-  {
-    if (const auto maybe_glyph = font.get_glyph(*str_temp); maybe_glyph)
-    {
-      text_width_px += maybe_glyph.value()->width_px;
-    }
-    ++str_temp;
-  }
-  text_width_px +=
-    (strlen(str) - 1) * font.get_spacing_px();  // This kind of assumes that every character in string has a glyph
+  const uint32_t text_width_px = get_string_width_px(str, font);
 
   const int32_t end_y = start_y + static_cast<int32_t>(font.get_height_px());
 
@@ -255,7 +357,7 @@ void draw_string_fast(
       is_white_on_black ? BLACK_COLOR : WHITE_COLOR);
   }
 
-  str_temp = str;
+  const char* str_temp = str;
   auto current_text_x = start_text_x;
   while (*str_temp != '\0')
   {
@@ -270,6 +372,16 @@ void draw_string_fast(
   }
 }
 
+void font_error_unsupported_format()
+{
+  Serial.println("Error unsupported format");
+}
+
+void font_error_too_many_glyphs()
+{
+  Serial.println("Error too many glyphs in the font");
+}
+
 uint8_t LvFontWrapper::LvGlyph::get_color(const uint32_t x_px, const uint32_t y_px) const
 {
   // Monospace font offset the font
@@ -301,132 +413,6 @@ uint8_t LvFontWrapper::LvGlyph::get_color(const uint32_t x_px, const uint32_t y_
   return two_pixels_byte & 0x0F;
 }
 
-LvFontWrapper::LvFontWrapper(const lv_font_t* font, const bool is_monospace)
-  : font_(font), height_px_(font_->h_px - font_->h_top_skip_px - font_->h_bot_skip_px)
-{
-  assert(font_->glyph_dsc != NULL || font_->new_glyph_dsc != NULL);
-  auto add_character = [this](const uint32_t unicode, const uint32_t index) {
-    if (font_->glyph_dsc != NULL)
-    {
-      LvGlyph glyph{
-        .width_px = font_->glyph_dsc[index].w_px,  // Will be updated if monospace
-        .bitmap_width_px = font_->glyph_dsc[index].w_px,
-        .height_px = height_px_,
-        .width_with_spacing_px = font_->glyph_dsc[index].w_px + font_->spacing_px,
-        .skip_top_px = font_->h_top_skip_px,
-        .raw_bytes = font_->glyph_bitmap + font_->glyph_dsc[index].glyph_index,
-        .box_w =
-          (font_->glyph_dsc[index].w_px % 2 == 0 ? font_->glyph_dsc[index].w_px
-                                                 : font_->glyph_dsc[index].w_px + 1),  // Padding for odd width
-        .box_h = font_->h_px,
-        .ofs_x = 0,
-        .ofs_y = 0};
-      unicode_to_char_.emplace(unicode, glyph);
-    }
-    else if (font_->new_glyph_dsc != NULL)
-    {
-      // +1 is added here, because the first character is a null character
-      const auto& descriptor = font_->new_glyph_dsc[index + 1];
-      const uint32_t width = descriptor.adv_w / 16;
-      // We don't support negative x offset, so we set negative value to zero
-      const auto ofs_x = static_cast<uint32_t>(descriptor.ofs_x < 0 ? 0 : descriptor.ofs_x);
-      // For some reason the y offset is convoluted and it's an offset relative to the "base line" of the character.
-      // The offset is converted to an offset relative to the top left corner of the character.
-      const auto ofs_y = height_px_ - (descriptor.box_h + descriptor.ofs_y + font_->base_line);
-      LvGlyph glyph{
-        .width_px = width,  // Will be updated if monospace
-        .bitmap_width_px = width,
-        .height_px = height_px_,
-        .width_with_spacing_px = width + font_->spacing_px,
-        .skip_top_px = font_->h_top_skip_px,
-        .raw_bytes = font_->glyph_bitmap + descriptor.bitmap_index,
-        .box_w = descriptor.box_w,
-        .box_h = descriptor.box_h,
-        .ofs_x = ofs_x,
-        .ofs_y = ofs_y};
-      unicode_to_char_.emplace(unicode, glyph);
-    }
-  };
-
-  // There are two way to encode the unicode, either as a continious array or as the range between unicode_first and
-  // unicode_last
-  if (font_->unicode_list != NULL)
-  {
-    uint32_t i = 0;
-    while (font_->unicode_list[i] != 0)
-    {
-      add_character(font_->unicode_list[i], i);
-      ++i;
-    }
-  } // This is the range of unicode format, but not all unicode in range have a supported glyph
-  else if (font_->format_type == LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL)
-  {
-    if (font_->glyph_id_ofs_list != NULL)
-    {
-      for (uint32_t unicode = font_->unicode_first; unicode < font_->unicode_last; ++unicode)
-      {
-        const auto offset = unicode - font_->unicode_first;
-        // Don't add glyph for unicode within the range which have 0 in the glyph_id_ofs_list
-        // The very first unicode of the range can be zero, tho
-        if (font_->glyph_id_ofs_list[offset] == 0 && unicode != font_->unicode_first)
-        {
-          continue;
-        }
-        add_character(unicode, font_->glyph_id_start - 1 + font_->glyph_id_ofs_list[offset]);
-      }
-    }
-  }
-  else if (font_->format_type == LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY)
-  {
-    for (uint32_t unicode = font_->unicode_first; unicode < font_->unicode_last; ++unicode)
-    {
-      add_character(unicode, unicode - font_->unicode_first);
-    }
-  }
-  else
-  {
-    Serial.println("Error unsupported format");
-  }
-
-  // Update width_px to the largest glyph width
-  if (is_monospace && !unicode_to_char_.empty())
-  {
-    const auto max_width =
-      std::max_element(unicode_to_char_.begin(), unicode_to_char_.end(), [](const auto& a, const auto& b) {
-        return a.second.width_px < b.second.width_px;
-      })->second.width_px;
-    for (auto& [unicode, glyph] : unicode_to_char_)
-    {
-      // 0-9
-      if (48 <= unicode && unicode <= 57)
-      {
-        glyph.width_px = max_width;
-        glyph.width_with_spacing_px = max_width + font_->spacing_px;
-      }
-    }
-  }
-}
-
-std::optional<const LvFontWrapper::LvGlyph*> LvFontWrapper::get_glyph(const char c) const
-{
-  const auto iter = unicode_to_char_.find(static_cast<uint32_t>(c));
-  if (iter == unicode_to_char_.end())
-  {
-    return {};
-  }
-  return std::optional<const LvGlyph*>(&iter->second);
-};
-
-uint32_t LvFontWrapper::get_height_px() const
-{
-  return height_px_;
-}
-
-uint32_t LvFontWrapper::get_spacing_px() const
-{
-  return font_->spacing_px;
-}
-
 void draw_image(Display& display, const lv_img_dsc_t& img, const uint32_t center_x, const uint32_t center_y)
 {
   const uint32_t start_x = center_x - img.w_px / 2;
@@ -434,6 +420,18 @@ void draw_image(Display& display, const lv_img_dsc_t& img, const uint32_t center
   draw_image_from_top_left(display, img, start_x, start_y);
 }
 
+#ifdef LCD_DISPLAY_LIST
+static void rasterize_lv_image(Display& display, const DrawCommand& command)
+{
+  draw_image_from_top_left(
+    display,
+    *static_cast<const lv_img_dsc_t*>(command.data),
+    static_cast<uint32_t>(command.x_start),
+    static_cast<uint32_t>(command.y_start),
+    command.flags);
+}
+#endif
+
 void draw_image_from_top_left(
   Display& display, const lv_img_dsc_t& img, const uint32_t start_x, const uint32_t start_y, const bool vertical_mirror)
 {
@@ -444,6 +442,20 @@ void draw_image_from_top_left(
     .y_end = static_cast<int32_t>(start_y + img.h_px)
   };
   rect.clip_to_screen();
+#ifdef LCD_DISPLAY_LIST
+  if (display.is_recording())
+  {
+    display.record_command(DrawCommand{
+      .rasterize = &rasterize_lv_image,
+      .bounds = rect,
+      .data = &img,
+      .x_start = static_cast<int32_t>(start_x),
+      .y_start = static_cast<int32_t>(start_y),
+      .flags = vertical_mirror});
+    return;
+  }
+#endif
+  rect = rect.intersected(display.get_clip_rect());
   if (rect.is_empty())
   {
     return;
@@ -456,9 +468,9 @@ void draw_image_from_top_left(
   const uint32_t span = img.has_alpha ? 4 : 3;
   const auto width = rect.width();
   const auto height = rect.height();
+  uint16_t row_colors[LCD_WIDTH];
   for (uint32_t y = 0; y < height; ++y)
   {
-    uint32_t rgb444_color = 0;
     for (uint32_t x = 0; x < width; ++x)
     {
       uint32_t r = 0;
@@ -480,9 +492,10 @@ void draw_image_from_top_left(
       g >>= 4;
       b >>= 4;
       // Convert 4bit grayscale to four 4bit RGB
-      rgb444_color = ((r << 8) | (g << 4) | b);
-      display.set_pixel_unsafe(static_cast<uint16_t>(rect.x_start + x), static_cast<uint16_t>(rect.y_start + y), rgb444_color);
+      row_colors[x] = ((r << 8) | (g << 4) | b);
     }
+    display.set_span_unsafe(
+      static_cast<uint16_t>(rect.x_start), static_cast<uint16_t>(rect.y_start + y), row_colors, width);
   }
   // DEV_SPI_BEGIN_TRANS;
   // LCD_SetWindow(start_x, start_y, end_x, end_y + 1);
@@ -523,6 +536,84 @@ void draw_image_from_top_left(
   // DEV_SPI_END_TRANS;
 }
 
+void draw_image(Display& display, const rgb444_img_dsc_t& img, const uint32_t center_x, const uint32_t center_y)
+{
+  const uint32_t start_x = center_x - img.w_px / 2;
+  const uint32_t start_y = center_y - img.h_px / 2;
+  draw_image_from_top_left(display, img, start_x, start_y);
+}
+
+#ifdef LCD_DISPLAY_LIST
+static void rasterize_packed_image(Display& display, const DrawCommand& command)
+{
+  draw_image_from_top_left(
+    display,
+    *static_cast<const rgb444_img_dsc_t*>(command.data),
+    static_cast<uint32_t>(command.x_start),
+    static_cast<uint32_t>(command.y_start),
+    command.flags);
+}
+#endif
+
+void draw_image_from_top_left(
+  Display& display,
+  const rgb444_img_dsc_t& img,
+  const uint32_t start_x,
+  const uint32_t start_y,
+  const bool vertical_mirror)
+{
+  Rect rect{
+    .x_start = static_cast<int32_t>(start_x),
+    .y_start = static_cast<int32_t>(start_y),
+    .x_end = static_cast<int32_t>(start_x + img.w_px),
+    .y_end = static_cast<int32_t>(start_y + img.h_px)
+  };
+  rect.clip_to_screen();
+#ifdef LCD_DISPLAY_LIST
+  if (display.is_recording())
+  {
+    display.record_command(DrawCommand{
+      .rasterize = &rasterize_packed_image,
+      .bounds = rect,
+      .data = &img,
+      .x_start = static_cast<int32_t>(start_x),
+      .y_start = static_cast<int32_t>(start_y),
+      .flags = vertical_mirror});
+    return;
+  }
+#endif
+  rect = rect.intersected(display.get_clip_rect());
+  if (rect.is_empty())
+  {
+    return;
+  }
+
+  // When the image is partially off-screen on the left/top, offset into the bitmap
+  const uint32_t bitmap_x_offset = static_cast<uint32_t>(rect.x_start - static_cast<int32_t>(start_x));
+  const uint32_t bitmap_y_offset = static_cast<uint32_t>(rect.y_start - static_cast<int32_t>(start_y));
+
+  const uint32_t row_len = (img.w_px + 1) / 2 * 3;
+  const auto width = rect.width();
+  const auto height = rect.height();
+  uint16_t row_colors[LCD_WIDTH];
+  for (uint32_t y = 0; y < height; ++y)
+  {
+    const uint8_t* row = img.data + (y + bitmap_y_offset) * row_len;
+    if (!vertical_mirror)
+    {
+      display.copy_packed_span_unsafe(
+        static_cast<uint16_t>(rect.x_start), static_cast<uint16_t>(rect.y_start + y), row, bitmap_x_offset, width);
+      continue;
+    }
+    for (uint32_t x = 0; x < width; ++x)
+    {
+      row_colors[x] = get_packed_pixel(row, img.w_px - (x + bitmap_x_offset) - 1);
+    }
+    display.set_span_unsafe(
+      static_cast<uint16_t>(rect.x_start), static_cast<uint16_t>(rect.y_start + y), row_colors, width);
+  }
+}
+
 /// Maximum supported corner radius for the arc table.
 /// Limited by the screen dimensions (LCD_WIDTH / 2 = 160, LCD_HEIGHT / 2 = 120).
 constexpr int32_t k_max_arc_radius = 128;
@@ -535,9 +626,9 @@ constexpr int32_t k_max_arc_radius = 128;
 static const int32_t* get_arc_table(const int32_t r)
 {
   constexpr int32_t max_cached_radii = 3;
-  static int32_t cached_radii[max_cached_radii] = {-1, -1, -1};
-  static int32_t cached_arcs[max_cached_radii][k_max_arc_radius];
-  static int32_t next_slot = 0;
+  static DEV_THREAD_LOCAL int32_t cached_radii[max_cached_radii] = {-1, -1, -1};
+  static DEV_THREAD_LOCAL int32_t cached_arcs[max_cached_radii][k_max_arc_radius];
+  static DEV_THREAD_LOCAL int32_t next_slot = 0;
 
   // Check if already cached
   for (int32_t i = 0; i < max_cached_radii; ++i)
@@ -575,6 +666,22 @@ static const int32_t* get_arc_table(const int32_t r)
   return arc_x;
 }
 
+#ifdef LCD_DISPLAY_LIST
+static void rasterize_rounded_rectangle(Display& display, const DrawCommand& command)
+{
+  draw_rounded_rectangle(
+    display,
+    command.x_start,
+    command.y_start,
+    command.x_end,
+    command.y_end,
+    command.flags & 1,
+    command.flags & 2,
+    command.flags & 4,
+    static_cast<int32_t>(command.value));
+}
+#endif
+
 /// Implementation of a fast anti-aliased rounded rectangle.
 /// Based on Fast Anti-Aliased Circle Generation". In James Arvo (ed.). Graphics Gems II.
 void draw_rounded_rectangle(
@@ -600,6 +707,23 @@ void draw_rounded_rectangle(
   {
     return;
   }
+#ifdef LCD_DISPLAY_LIST
+  if (display.is_recording())
+  {
+    display.record_command(DrawCommand{
+      .rasterize = &rasterize_rounded_rectangle,
+      .bounds = rect,
+      .x_start = start_x,
+      .y_start = start_y,
+      .x_end = end_x,
+      .y_end = end_y,
+      .value = static_cast<uint32_t>(corner_radius_px),
+      .flags = static_cast<uint8_t>((is_white_on_black ? 1 : 0) | (rounded_left ? 2 : 0) | (rounded_right ? 4 : 0)),
+      // The diagonal pixel of the corners isn't written
+      .is_opaque = false});
+    return;
+  }
+#endif
 
   const int32_t clipped_start_x = rect.x_start;
   const int32_t clipped_start_y = rect.y_start;
@@ -615,13 +739,7 @@ void draw_rounded_rectangle(
   if (r <= 0)
   {
     // Degenerate to a plain filled rectangle.
-    for (int32_t j = clipped_start_y; j < clipped_end_y; ++j)
-    {
-      for (int32_t i = clipped_start_x; i < clipped_end_x; ++i)
-      {
-        display.set_pixel_unsafe(static_cast<uint16_t>(i), static_cast<uint16_t>(j), WHITE_COLOR);
-      }
-    }
+    display.draw_rectangle(clipped_start_x, clipped_start_y, clipped_end_x, clipped_end_y, WHITE_COLOR);
     return;
   }
 
@@ -697,18 +815,15 @@ void draw_rounded_rectangle(
   }
 
   // --- Fill the interior (cross-shaped area) ---
-  // All loops are clamped to the clipped bounds so we never call
-  // set_pixel_unsafe with out-of-screen coordinates.
+  // All fills are clamped to the clipped bounds so we never write
+  // out-of-screen pixels.
 
   // Horizontal band (full width)
   const int32_t h_y_start = MAX(top_corner_center_y, clipped_start_y);
   const int32_t h_y_end = MIN(bot_corner_center_y, clipped_end_y - 1);
-  for (int32_t j = h_y_start; j <= h_y_end; ++j)
+  if (h_y_start <= h_y_end)
   {
-    for (int32_t i = clipped_start_x; i < clipped_end_x; ++i)
-    {
-      display.set_pixel_unsafe(static_cast<uint16_t>(i), static_cast<uint16_t>(j), WHITE_COLOR);
-    }
+    display.draw_rectangle(clipped_start_x, h_y_start, clipped_end_x, h_y_end + 1, WHITE_COLOR);
   }
 
   // Top vertical strip (between the left and right corner arcs)
@@ -716,22 +831,16 @@ void draw_rounded_rectangle(
   const int32_t top_y_end = MIN(clipped_start_y + r - 1, clipped_end_y - 1);
   const int32_t mid_x_start = MAX(left_corner_center_x, clipped_start_x);
   const int32_t mid_x_end = MIN(right_corner_center_x, clipped_end_x - 1);
-  for (int32_t j = top_y_start; j <= top_y_end; ++j)
+  if (mid_x_start <= mid_x_end && top_y_start <= top_y_end)
   {
-    for (int32_t i = mid_x_start; i <= mid_x_end; ++i)
-    {
-      display.set_pixel_unsafe(static_cast<uint16_t>(i), static_cast<uint16_t>(j), WHITE_COLOR);
-    }
+    display.draw_rectangle(mid_x_start, top_y_start, mid_x_end + 1, top_y_end + 1, WHITE_COLOR);
   }
 
   // Bottom vertical strip (between the left and right corner arcs)
   const int32_t bot_y_start = MAX(clipped_end_y - r, clipped_start_y);
   const int32_t bot_y_end = clipped_end_y - 1;
-  for (int32_t j = bot_y_start; j <= bot_y_end; ++j)
+  if (mid_x_start <= mid_x_end && bot_y_start <= bot_y_end)
   {
-    for (int32_t i = mid_x_start; i <= mid_x_end; ++i)
-    {
-      display.set_pixel_unsafe(static_cast<uint16_t>(i), static_cast<uint16_t>(j), WHITE_COLOR);
-    }
+    display.draw_rectangle(mid_x_start, bot_y_start, mid_x_end + 1, bot_y_end + 1, WHITE_COLOR);
   }
 }
@@ -4,9 +4,9 @@
 
 #include "LCD_Driver.h"
 
+#include <array>
 #include <optional>
 #include <stdint.h>
-#include <unordered_map>
 #ifdef SIM
 #include "sim/arduino.h"
 #else
@@ -15,49 +15,6 @@
 const uint32_t WHITE_COLOR = 0xfff;
 const uint32_t BLACK_COLOR = 0x0;
 
-// Lightweight rectangle for clipping. Uses exclusive-end (x_end,y_end is first pixel outside).
-// All methods should be inlined by the compiler with any optimization level.
-struct Rect
-{
-  int32_t x_start{0};  // left, inclusive
-  int32_t y_start{0};  // top, inclusive
-  int32_t x_end{LCD_WIDTH};  // right, exclusive
-  int32_t y_end{LCD_HEIGHT};  // bottom, exclusive
-
-  void clip_to_screen()
-  {
-    if (x_start < 0)
-    {
-      x_start = 0;
-    }
-    if (y_start < 0)
-    {
-      y_start = 0;
-    }
-    if (x_end > static_cast<int32_t>(LCD_WIDTH))
-    {
-      x_end = static_cast<int32_t>(LCD_WIDTH);
-    }
-    if (y_end > static_cast<int32_t>(LCD_HEIGHT))
-    {
-      y_end = static_cast<int32_t>(LCD_HEIGHT);
-    }
-  }
-
-  inline bool is_empty() const
-  {
-    return x_start >= x_end || y_start >= y_end;
-  }
-  inline uint32_t width() const
-  {
-    return static_cast<uint32_t>(x_end - x_start);
-  }
-  inline uint32_t height() const
-  {
-    return static_cast<uint32_t>(y_end - y_start);
-  }
-};
-
 // New format for glyph descriptor, it includes a bounding box offset, so the bitmap doesn't have to include
 // transparent pixels.
 struct lv_font_fmt_txt_glyph_dsc_t
@@ -123,6 +80,13 @@ struct lv_font_t
   lv_font_fmt_txt_cmap_type_t format_type{LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY};
 };
 
+/// Errors of a font which LvFontWrapper can't hold. They aren't constexpr, so building a constexpr wrapper of such a font
+/// fails to compile on the call. A wrapper built at runtime prints the error instead.
+void font_error_unsupported_format();
+void font_error_too_many_glyphs();
+
+/// Glyphs of a font, indexed directly by their unicode. The table is built at compile time when the wrapper is
+/// constexpr, so it lives in flash and a lookup is a single index.
 class LvFontWrapper
 {
 public:
@@ -131,36 +95,178 @@ public:
     uint8_t get_color(const uint32_t bitmap_x_px, const uint32_t y_px) const;
 
     // When monospace this is fixed
-    uint32_t width_px;
+    uint32_t width_px{0};
     // Real width of the glyph
-    uint32_t bitmap_width_px;
-    uint32_t height_px;  // height_px = Real height - skip_top_px - bot_skip_px
-    uint32_t width_with_spacing_px;
-    uint32_t skip_top_px;
-    const uint8_t* raw_bytes;
+    uint32_t bitmap_width_px{0};
+    uint32_t height_px{0};  // height_px = Real height - skip_top_px - bot_skip_px
+    uint32_t width_with_spacing_px{0};
+    uint32_t skip_top_px{0};
+    // Null when the font doesn't have a glyph for this unicode
+    const uint8_t* raw_bytes{nullptr};
     // Width of the glyph's bitmap bounding box
-    uint32_t box_w;
+    uint32_t box_w{0};
     // Height of the glyph's bitmap bounding box
-    uint32_t box_h;
+    uint32_t box_h{0};
     // x offset of the bounding box. Measured from the left of the character.
-    uint32_t ofs_x;
+    uint32_t ofs_x{0};
     // y offset of the bounding box. Measured from the top of the character.
-    uint32_t ofs_y;
+    uint32_t ofs_y{0};
   };
 
-  LvFontWrapper(const lv_font_t* font, const bool is_monospace = false);
-  std::optional<const LvGlyph*> get_glyph(const char c) const;
-  uint32_t get_height_px() const;
-  uint32_t get_spacing_px() const;
+  constexpr LvFontWrapper(const lv_font_t* font, const bool is_monospace = false);
+  constexpr std::optional<const LvGlyph*> get_glyph(const char c) const
+  {
+    const uint32_t unicode = static_cast<uint8_t>(c);
+    if (unicode < font_->unicode_first || unicode - font_->unicode_first >= max_glyph_count)
+    {
+      return {};
+    }
+    const LvGlyph& glyph = glyphs_[unicode - font_->unicode_first];
+    if (glyph.raw_bytes == nullptr)
+    {
+      return {};
+    }
+    return &glyph;
+  }
+  constexpr uint32_t get_height_px() const
+  {
+    return height_px_;
+  }
+  constexpr uint32_t get_spacing_px() const
+  {
+    return font_->spacing_px;
+  }
 
 private:
-  // Unicode to the glyph
-  std::unordered_map<uint32_t, LvGlyph> unicode_to_char_;
+  constexpr void add_character(const uint32_t unicode, const uint32_t index);
+
+  /// Our fonts cover at most the printable ASCII characters (32 to 127), a wider font fails to compile
+  static constexpr uint32_t max_glyph_count = 96;
+  // Glyph of each unicode starting from unicode_first
+  std::array<LvGlyph, max_glyph_count> glyphs_{};
   // Actual font informations
   const lv_font_t* font_;
   uint32_t height_px_;
 };
 
+constexpr void LvFontWrapper::add_character(const uint32_t unicode, const uint32_t index)
+{
+  if (unicode < font_->unicode_first || unicode - font_->unicode_first >= max_glyph_count)
+  {
+    font_error_too_many_glyphs();
+    return;
+  }
+  LvGlyph& glyph = glyphs_[unicode - font_->unicode_first];
+  // Keep the first glyph of a unicode which is listed twice
+  if (glyph.raw_bytes != nullptr)
+  {
+    return;
+  }
+  if (font_->glyph_dsc != nullptr)
+  {
+    const auto& descriptor = font_->glyph_dsc[index];
+    glyph.width_px = descriptor.w_px;  // Will be updated if monospace
+    glyph.bitmap_width_px = descriptor.w_px;
+    glyph.height_px = height_px_;
+    glyph.width_with_spacing_px = descriptor.w_px + font_->spacing_px;
+    glyph.skip_top_px = font_->h_top_skip_px;
+    glyph.raw_bytes = font_->glyph_bitmap + descriptor.glyph_index;
+    glyph.box_w = descriptor.w_px % 2 == 0 ? descriptor.w_px : descriptor.w_px + 1;  // Padding for odd width
+    glyph.box_h = font_->h_px;
+    glyph.ofs_x = 0;
+    glyph.ofs_y = 0;
+  }
+  else if (font_->new_glyph_dsc != nullptr)
+  {
+    // +1 is added here, because the first character is a null character
+    const auto& descriptor = font_->new_glyph_dsc[index + 1];
+    const uint32_t width = descriptor.adv_w / 16;
+    glyph.width_px = width;  // Will be updated if monospace
+    glyph.bitmap_width_px = width;
+    glyph.height_px = height_px_;
+    glyph.width_with_spacing_px = width + font_->spacing_px;
+    glyph.skip_top_px = font_->h_top_skip_px;
+    glyph.raw_bytes = font_->glyph_bitmap + descriptor.bitmap_index;
+    glyph.box_w = descriptor.box_w;
+    glyph.box_h = descriptor.box_h;
+    // We don't support negative x offset, so we set negative value to zero
+    glyph.ofs_x = static_cast<uint32_t>(descriptor.ofs_x < 0 ? 0 : descriptor.ofs_x);
+    // For some reason the y offset is convoluted and it's an offset relative to the "base line" of the character.
+    // The offset is converted to an offset relative to the top left corner of the character.
+    glyph.ofs_y = height_px_ - (descriptor.box_h + descriptor.ofs_y + font_->base_line);
+  }
+}
+
+constexpr LvFontWrapper::LvFontWrapper(const lv_font_t* font, const bool is_monospace)
+  : font_(font), height_px_(font->h_px - font->h_top_skip_px - font->h_bot_skip_px)
+{
+  if (font_->unicode_last - font_->unicode_first >= max_glyph_count)
+  {
+    font_error_too_many_glyphs();
+    return;
+  }
+  // There are two way to encode the unicode, either as a continious array or as the range between unicode_first and
+  // unicode_last
+  if (font_->unicode_list != nullptr)
+  {
+    for (uint32_t i = 0; font_->unicode_list[i] != 0; ++i)
+    {
+      add_character(font_->unicode_list[i], i);
+    }
+  } // This is the range of unicode format, but not all unicode in range have a supported glyph
+  else if (font_->format_type == LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL)
+  {
+    if (font_->glyph_id_ofs_list != nullptr)
+    {
+      for (uint32_t unicode = font_->unicode_first; unicode < font_->unicode_last; ++unicode)
+      {
+        const auto offset = unicode - font_->unicode_first;
+        // Don't add glyph for unicode within the range which have 0 in the glyph_id_ofs_list
+        // The very first unicode of the range can be zero, tho
+        if (font_->glyph_id_ofs_list[offset] == 0 && unicode != font_->unicode_first)
+        {
+          continue;
+        }
+        add_character(unicode, font_->glyph_id_start - 1 + font_->glyph_id_ofs_list[offset]);
+      }
+    }
+  }
+  else if (font_->format_type == LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY)
+  {
+    for (uint32_t unicode = font_->unicode_first; unicode < font_->unicode_last; ++unicode)
+    {
+      add_character(unicode, unicode - font_->unicode_first);
+    }
+  }
+  else
+  {
+    font_error_unsupported_format();
+  }
+
+  // Update width_px of the digits to the largest glyph width
+  if (is_monospace)
+  {
+    uint32_t max_width = 0;
+    for (const auto& glyph : glyphs_)
+    {
+      max_width = glyph.width_px > max_width ? glyph.width_px : max_width;
+    }
+    for (uint32_t unicode = '0'; unicode <= '9'; ++unicode)
+    {
+      if (unicode < font_->unicode_first || unicode - font_->unicode_first >= max_glyph_count)
+      {
+        continue;
+      }
+      LvGlyph& glyph = glyphs_[unicode - font_->unicode_first];
+      if (glyph.raw_bytes != nullptr)
+      {
+        glyph.width_px = max_width;
+        glyph.width_with_spacing_px = max_width + font_->spacing_px;
+      }
+    }
+  }
+}
+
 void draw_character_fast(
   Display& display,
   const LvFontWrapper::LvGlyph* glyph,
@@ -178,6 +284,9 @@ enum class TextAlign : uint8_t
   enum_length
 };
 
+/// Width in pixels of the string drawn by draw_string_fast()
+uint32_t get_string_width_px(const char* str, const LvFontWrapper& font);
+
 void draw_string_fast(
   Display& display,
   const char* str,
@@ -218,6 +327,23 @@ void draw_image_from_top_left(
   const uint32_t start_y,
   const bool vertical_mirror = false);
 
+// Image already in the framebuffer's format: RGB444 with 2 pixels packed in 3 bytes. Rows with an odd width are padded
+// with one pixel, so every row starts on a byte. Generated with script/convert_lvgl_image.py
+struct rgb444_img_dsc_t
+{
+  uint32_t w_px;
+  uint32_t h_px;
+  const uint8_t* data;
+};
+
+void draw_image(Display& display, const rgb444_img_dsc_t& img, const uint32_t center_x, const uint32_t center_y);
+void draw_image_from_top_left(
+  Display& display,
+  const rgb444_img_dsc_t& img,
+  const uint32_t start_x,
+  const uint32_t start_y,
+  const bool vertical_mirror = false);
+
 void draw_rounded_rectangle(
   Display& display,
   const int32_t start_x,
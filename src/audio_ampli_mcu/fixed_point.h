@@ -0,0 +1,117 @@
+#ifndef FIXED_POINT_GUARD_H_
+#define FIXED_POINT_GUARD_H_
+
+#include <stdint.h>
+
+// Q16.16 fixed point numbers for the animations. The RP2040's Cortex-M0+ has no FPU, every float operation is a
+// software routine, while these are a few integer instructions. They also give the same results on the simulator and
+// on the hardware.
+
+/// Q16.16 number: 16 bits of integer part and 16 bits of fraction
+using fixed_t = int32_t;
+
+constexpr fixed_t fixed_one = 1 << 16;
+
+constexpr fixed_t int_to_fixed(const int32_t value)
+{
+  return value * fixed_one;
+}
+
+/// Only meant for constants, the conversion is done by the compiler
+constexpr fixed_t float_to_fixed(const float value)
+{
+  return static_cast<fixed_t>(value * fixed_one + (value < 0 ? -0.5f : 0.5f));
+}
+
+/// Rounded down, toward minus infinity
+constexpr int32_t fixed_to_int(const fixed_t value)
+{
+  return value >> 16;
+}
+
+constexpr int32_t fixed_round(const fixed_t value)
+{
+  return (value + fixed_one / 2) >> 16;
+}
+
+constexpr fixed_t fixed_mul(const fixed_t a, const fixed_t b)
+{
+  return static_cast<fixed_t>((static_cast<int64_t>(a) * b) >> 16);
+}
+
+/// `numerator / denominator` as a fixed point number
+constexpr fixed_t fixed_ratio(const int32_t numerator, const int32_t denominator)
+{
+  return static_cast<fixed_t>(static_cast<int64_t>(numerator) * fixed_one / denominator);
+}
+
+/// Progress of an animation between 0 and fixed_one, reached once `elapsed_ms` >= `duration_ms`
+constexpr fixed_t animation_progress(const uint32_t elapsed_ms, const uint32_t duration_ms)
+{
+  if (elapsed_ms >= duration_ms)
+  {
+    return fixed_one;
+  }
+  return static_cast<fixed_t>((static_cast<uint64_t>(elapsed_ms) << 16) / duration_ms);
+}
+
+/// Value between `from` and `to` at the progress `t` (0 to fixed_one), rounded down
+constexpr int32_t lerp(const int32_t from, const int32_t to, const fixed_t t)
+{
+  return from + fixed_to_int(fixed_mul(int_to_fixed(to - from), t));
+}
+
+// Easing curves, they map a progress from 0 to fixed_one to a progress from 0 to fixed_one
+
+/// Starts fast and slows down at the end
+constexpr fixed_t ease_out_quad(const fixed_t t)
+{
+  const fixed_t remaining = fixed_one - t;
+  return fixed_one - fixed_mul(remaining, remaining);
+}
+
+/// Starts and ends slowly (smoothstep: 3t² - 2t³)
+constexpr fixed_t ease_in_out(const fixed_t t)
+{
+  return fixed_mul(fixed_mul(t, t), int_to_fixed(3) - 2 * t);
+}
+
+// Sin table: Q8.8 format, 256 entries for a full circle.
+// sin_lut[a] = round(256 * sin(2*pi*a/256))
+inline constexpr int16_t sin_lut[256] = {
+  0, 6, 13, 19, 25, 31, 38, 44, 50, 56, 62, 68, 74, 80, 86, 92,
+  98, 104, 109, 115, 121, 126, 132, 137, 142, 147, 152, 157, 162, 167, 172, 177,
+  181, 185, 190, 194, 198, 202, 206, 209, 213, 216, 220, 223, 226, 229, 231, 234,
+  237, 239, 241, 243, 245, 247, 248, 250, 251, 252, 253, 254, 255, 255, 256, 256,
+  256, 256, 256, 255, 255, 254, 253, 252, 251, 250, 248, 247, 245, 243, 241, 239,
+  237, 234, 231, 229, 226, 223, 220, 216, 213, 209, 206, 202, 198, 194, 190, 185,
+  181, 177, 172, 167, 162, 157, 152, 147, 142, 137, 132, 126, 121, 115, 109, 104,
+  98, 92, 86, 80, 74, 68, 62, 56, 50, 44, 38, 31, 25, 19, 13, 6,
+  0, -6, -13, -19, -25, -31, -38, -44, -50, -56, -62, -68, -74, -80, -86, -92,
+  -98, -104, -109, -115, -121, -126, -132, -137, -142, -147, -152, -157, -162, -167, -172, -177,
+  -181, -185, -190, -194, -198, -202, -206, -209, -213, -216, -220, -223, -226, -229, -231, -234,
+  -237, -239, -241, -243, -245, -247, -248, -250, -251, -252, -253, -254, -255, -255, -256, -256,
+  -256, -256, -256, -255, -255, -254, -253, -252, -251, -250, -248, -247, -245, -243, -241, -239,
+  -237, -234, -231, -229, -226, -223, -220, -216, -213, -209, -206, -202, -198, -194, -190, -185,
+  -181, -177, -172, -167, -162, -157, -152, -147, -142, -137, -132, -126, -121, -115, -109, -104,
+  -98, -92, -86, -80, -74, -68, -62, -56, -50, -44, -38, -31, -25, -19, -13, -6,
+};
+
+/// Sine of an angle in turns (fixed_one is a full circle, 2*pi radians), interpolated between the entries of sin_lut
+constexpr fixed_t fixed_sin(const fixed_t turns)
+{
+  // 8 bits of table index and 8 bits between two entries
+  const uint32_t index = (static_cast<uint32_t>(turns) >> 8) & 0xff;
+  const int32_t fraction = turns & 0xff;
+  const int32_t current = sin_lut[index];
+  const int32_t next = sin_lut[(index + 1) & 0xff];
+  // Q8.8 times 256 is Q16.16
+  return current * 256 + (next - current) * fraction;
+}
+
+constexpr fixed_t fixed_cos(const fixed_t turns)
+{
+  return fixed_sin(turns + fixed_one / 4);
+}
+
+#endif  // FIXED_POINT_GUARD_H_
@@ -0,0 +1,89 @@
+#include "frame_scheduler.h"
+
+#include <algorithm>
+#ifdef SIM
+#include "sim/arduino.h"
+#else
+#include <Arduino.h>
+#endif
+
+FrameScheduler::FrameScheduler(const uint32_t frame_interval_ms) : frame_interval_ms_(frame_interval_ms)
+{
+}
+
+bool FrameScheduler::begin_frame(const bool is_display_ready)
+{
+  const uint32_t now_ms = millis();
+  if (!is_display_ready || (has_started_ && static_cast<int32_t>(now_ms - next_frame_ms_) < 0))
+  {
+    return false;
+  }
+
+  // A late frame doesn't make the next ones come sooner, the frames missed meanwhile are dropped
+  const uint32_t late_ms = now_ms - next_frame_ms_;
+  if (has_started_ && late_ms < frame_interval_ms_)
+  {
+    next_frame_ms_ += frame_interval_ms_;
+  }
+  else
+  {
+    if (has_started_)
+    {
+      stats_.dropped_count += late_ms / frame_interval_ms_;
+    }
+    next_frame_ms_ = now_ms + frame_interval_ms_;
+  }
+  has_started_ = true;
+  frame_start_us_ = micros();
+  return true;
+}
+
+void FrameScheduler::begin_push()
+{
+  push_start_us_ = micros();
+}
+
+void FrameScheduler::end_frame(const bool has_pushed)
+{
+  const uint32_t end_us = micros();
+  const uint32_t draw_us = push_start_us_ - frame_start_us_;
+  const uint32_t push_us = end_us - push_start_us_;
+
+  ++stats_.frame_count;
+  if (!has_pushed)
+  {
+    ++stats_.idle_count;
+  }
+  if (draw_us + push_us > frame_interval_ms_ * 1000)
+  {
+    ++stats_.over_budget_count;
+  }
+  stats_.draw_total_us += draw_us;
+  stats_.draw_max_us = std::max(stats_.draw_max_us, draw_us);
+  stats_.push_total_us += push_us;
+  stats_.push_max_us = std::max(stats_.push_max_us, push_us);
+}
+
+void FrameScheduler::report_frame_stats()
+{
+  const FrameStats& stats = stats_;
+  const uint32_t frame_count = std::max<uint32_t>(stats.frame_count, 1);
+  Serial.print("Frames: ");
+  Serial.print(static_cast<int>(stats.frame_count));
+  Serial.print(" drawn (");
+  Serial.print(static_cast<int>(stats.idle_count));
+  Serial.print(" without changes), ");
+  Serial.print(static_cast<int>(stats.dropped_count));
+  Serial.print(" dropped, ");
+  Serial.print(static_cast<int>(stats.over_budget_count));
+  Serial.print(" over budget, draw ");
+  Serial.print(static_cast<int>(stats.draw_total_us / frame_count));
+  Serial.print("us avg ");
+  Serial.print(static_cast<int>(stats.draw_max_us));
+  Serial.print("us max, push ");
+  Serial.print(static_cast<int>(stats.push_total_us / frame_count));
+  Serial.print("us avg ");
+  Serial.print(static_cast<int>(stats.push_max_us));
+  Serial.println("us max");
+  stats_ = FrameStats{};
+}
@@ -0,0 +1,52 @@
+#ifndef FRAME_SCHEDULER_GUARD_H_
+#define FRAME_SCHEDULER_GUARD_H_
+
+#include <stdint.h>
+
+/// Paces the frames drawn by the app. The inputs and controllers are serviced on every tick, a frame is only drawn
+/// and pushed when it's due and the screen is done with the previous one. A frame which can't be drawn in time is
+/// dropped instead of being caught up later, so a slow frame degrades the animations but never delays the inputs.
+class FrameScheduler
+{
+public:
+  explicit FrameScheduler(const uint32_t frame_interval_ms = default_frame_interval_ms);
+
+  /// Returns true when a frame must be drawn now. `is_display_ready` is false while the previous push is still going,
+  /// the frame is then retried on the next tick.
+  bool begin_frame(const bool is_display_ready);
+  /// The frame is drawn, what follows until end_frame() is the push
+  void begin_push();
+  /// `has_pushed` is false when nothing changed, so nothing was sent to the screen
+  void end_frame(const bool has_pushed);
+
+  struct FrameStats
+  {
+    uint32_t frame_count{0};
+    // Frames which didn't change anything on the screen
+    uint32_t idle_count{0};
+    // Frames skipped because the previous ones were late
+    uint32_t dropped_count{0};
+    // Frames which took longer than the frame interval to draw and push
+    uint32_t over_budget_count{0};
+    uint32_t draw_total_us{0};
+    uint32_t draw_max_us{0};
+    uint32_t push_total_us{0};
+    uint32_t push_max_us{0};
+  };
+  /// Print the time spent per frame drawing and pushing since the last report
+  void report_frame_stats();
+
+  /// ~60 FPS
+  static constexpr uint32_t default_frame_interval_ms = 16;
+
+private:
+  const uint32_t frame_interval_ms_;
+  /// millis() at which the next frame is due, the first frame is drawn right away
+  uint32_t next_frame_ms_{0};
+  bool has_started_{false};
+  uint32_t frame_start_us_{0};
+  uint32_t push_start_us_{0};
+  FrameStats stats_;
+};
+
+#endif  // FRAME_SCHEDULER_GUARD_H_
@@ -1,5 +1,7 @@
 #include "io_expander.h"
 
+#include "LCD_Driver.h"
+
 #ifdef SIM
 #include "sim/SPI.h"
 #endif
@@ -17,6 +19,7 @@ bool IoExpander::is_connected()
   {
     return maybe_is_connected_.value();
   }
+  LCD_finish_async_transfer();
   // To check if there is an IO expander, we write the interrupt polarity config, we then read the value back
   const uint8_t old_value = io_expander_.getInterruptPolarity();
   const uint8_t different_value = old_value == 1 ? 2 : 1;
@@ -30,6 +33,7 @@ bool IoExpander::is_connected()
 
 void IoExpander::begin()
 {
+  LCD_finish_async_transfer();
   const auto result = io_expander_.begin(false);
   if (!result)
   {
@@ -68,6 +72,7 @@ void IoExpander::init_input(const GpioPort& port, const uint8_t pin)
   const uint8_t mask = 1 << pin;
   // Set direction to 1 (INPUT)
   current_direction |= mask;
+  LCD_finish_async_transfer();
   io_expander_.pinMode8(port_idx, current_direction);
 }
 
@@ -135,6 +140,7 @@ void IoExpander::cache_write_pin(const GpioPort& port, const uint8_t pin, const
 
 void IoExpander::apply()
 {
+  LCD_finish_async_transfer();
   for (int port = 0; port < 2; ++port)
   {
     io_expander_.pinMode8(port, direction_gpio_[port]);
@@ -149,6 +155,7 @@ void IoExpander::force_reset_of_latches()
     return;
   }
 
+  LCD_finish_async_transfer();
   for (int port = 0; port < 2; ++port)
   {
     // Output pins have direction bit = 0; find those that are also LOW (value bit = 0)
@@ -1,6 +1,8 @@
 #include "options_view.h"
 
+#include "fixed_point.h"
 #include "left_arrow_img.h"
+#include "surface.h"
 
 #include <cstdlib>
 #include <cstring>
@@ -329,8 +331,10 @@ void OptionsView::menu_change(const IncrementDir& dir)
         option_ctrl_.increment_option(menu_item.option, dir);
         value_slide_.new_text = string_format_option(menu_item.option, false).value_or("");
 
-        // Only activate if the value changed
-        value_slide_.active = strcmp(value_slide_.old_text, value_slide_.new_text) != 0;
+        // Only activate if the value changed, a slide still running restarts from the current value. The small UI
+        // doesn't slide.
+        stop_value_slide();
+        value_slide_.active = use_large_ui_ && strcmp(value_slide_.old_text, value_slide_.new_text) != 0;
         value_slide_.dir = dir;
       }
       else
@@ -348,26 +352,31 @@ void OptionsView::menu_change(const IncrementDir& dir)
 void OptionsView::draw(Display& display, const bool has_state_changed)
 {
   draw_menu(display, has_state_changed);
-  draw_volume(display, has_state_changed);
+  // The whole screen is redrawn after the menu change's transition
+  if (!display.is_transition_active())
+  {
+    draw_volume(display, has_state_changed);
+  }
   on_button_press_ = false;
 }
 
 void OptionsView::draw_volume(Display& display, const bool has_state_changed)
 {
-  const int max_time_since_last_change = 5000;
-  static auto prev_volume = volume_ctrl_.get_volume_db();
-  const bool has_volume_changed = volume_ctrl_.get_volume_db() != prev_volume;
+  if (!maybe_prev_volume_.has_value())
+  {
+    maybe_prev_volume_ = volume_ctrl_.get_volume_db();
+  }
+  const bool has_volume_changed = volume_ctrl_.get_volume_db() != maybe_prev_volume_;
 
   if (!has_state_changed && !has_volume_changed)
   {
     return;
   }
 
-  static int time_since_last_change = -max_time_since_last_change;
   if (has_volume_changed)
   {
-    time_since_last_change = millis();
-    prev_volume = volume_ctrl_.get_volume_db();
+    time_since_last_change_ = millis();
+    maybe_prev_volume_ = volume_ctrl_.get_volume_db();
   }
 
   uint32_t y_end = 40;
@@ -379,7 +388,7 @@ void OptionsView::draw_volume(Display& display, const bool has_state_changed)
     y_text_top = y_end - font_.get_height_px();
   }
 
-  if (millis() - time_since_last_change >= max_time_since_last_change)
+  if (millis() - time_since_last_change_ >= max_time_since_last_change_)
   {
     return;
   }
@@ -410,109 +419,115 @@ void OptionsView::draw_volume(Display& display, const bool has_state_changed)
   draw_string_fast(display, option_buffer, LCD_WIDTH / 4, y_text_top, LCD_WIDTH * 3 / 4, font_);
 }
 
+bool OptionsView::draw_value_slide(Display& display, const uint32_t top_y_text)
+{
+  if (!value_slide_.active)
+  {
+    return false;
+  }
+  const uint32_t y_end = top_y_text + large_font_.get_height_px();
+
+  if (!value_slide_.maybe_new_surface)
+  {
+    auto text_bounds = [&](const char* text)
+    {
+      const int32_t width_px = static_cast<int32_t>(get_string_width_px(text, large_font_));
+      const int32_t start_x = static_cast<int32_t>(LCD_WIDTH / 2) - width_px / 2;
+      // +1 for the padding of a glyph with an odd width
+      return Rect{
+        .x_start = start_x,
+        .y_start = static_cast<int32_t>(top_y_text),
+        .x_end = start_x + width_px + 1,
+        .y_end = static_cast<int32_t>(y_end)};
+    };
+    auto rasterize_value = [&](Surface& surface, const char* text)
+    {
+      surface.fill(BLACK_COLOR);
+      display.begin_offscreen(surface);
+      draw_string_fast(display, text, 0, top_y_text, LCD_WIDTH, large_font_, true, false);
+      display.end_offscreen();
+    };
+    rasterize_value(value_slide_.maybe_old_surface.emplace(text_bounds(value_slide_.old_text)), value_slide_.old_text);
+    rasterize_value(value_slide_.maybe_new_surface.emplace(text_bounds(value_slide_.new_text)), value_slide_.new_text);
+    value_slide_.start_ms = millis();
+    value_slide_.top_y_text = top_y_text;
+  }
+
+  display.draw_rectangle(0, top_y_text, LCD_WIDTH, y_end, BLACK_COLOR);
+  const fixed_t progress = animation_progress(millis() - value_slide_.start_ms, slice_duration_ms);
+  if (progress == fixed_one)
+  {
+    // The surfaces aren't drawn by this frame, they can go
+    stop_value_slide();
+    return false;
+  }
+
+  // Without enough memory for the surface, the text is rasterized every frame
+  auto draw_value = [&](const Surface& surface, const char* text, const int offset)
+  {
+    if (offset + static_cast<int>(LCD_WIDTH) <= 0 || offset >= static_cast<int>(LCD_WIDTH))
+    {
+      return;
+    }
+    if (surface.is_valid())
+    {
+      display.blit(surface, offset);
+      return;
+    }
+    draw_string_fast(display, text, offset, top_y_text, offset + LCD_WIDTH, large_font_, true, false);
+  };
+  // Even offsets keep the pixel pairs of the surfaces aligned with the screen's, the rows are copied as is
+  const int progress_px = lerp(0, LCD_WIDTH, ease_in_out(progress)) & ~1;
+  const int old_offset = value_slide_.dir == IncrementDir::increment ? -progress_px : progress_px;
+  const int new_offset = value_slide_.dir == IncrementDir::increment ? static_cast<int>(LCD_WIDTH) - progress_px
+                                                                      : progress_px - static_cast<int>(LCD_WIDTH);
+  draw_value(*value_slide_.maybe_old_surface, value_slide_.old_text, old_offset);
+  draw_value(*value_slide_.maybe_new_surface, value_slide_.new_text, new_offset);
+  return true;
+}
+
+void OptionsView::stop_value_slide()
+{
+  value_slide_.active = false;
+  value_slide_.maybe_old_surface.reset();
+  value_slide_.maybe_new_surface.reset();
+}
+
 void OptionsView::draw_menu(Display& display, const bool has_state_changed)
 {
-  static auto prev_selected_menu = selected_menu_;
   auto& menu = get_selected_menu();
-  static auto prev_menu_selection = menu.maybe_selected_index;
-  const bool has_menu_changed = prev_selected_menu != selected_menu_;
-  const bool has_menu_selection_changed = prev_menu_selection != menu.maybe_selected_index;
+  if (!maybe_prev_selected_menu_.has_value())
+  {
+    maybe_prev_selected_menu_ = selected_menu_;
+    prev_menu_selection_ = menu.maybe_selected_index;
+  }
+  const bool has_menu_changed = maybe_prev_selected_menu_ != selected_menu_;
+  const bool has_menu_selection_changed = prev_menu_selection_ != menu.maybe_selected_index;
 
-  prev_selected_menu = selected_menu_;
+  maybe_prev_selected_menu_ = selected_menu_;
 
   if (
-    !has_state_changed && !has_menu_changed && !has_menu_selection_changed && !on_button_press_ && !menu_slide_.active)
+    !has_state_changed && !has_menu_changed && !has_menu_selection_changed && !on_button_press_ && !menu_slide_.active &&
+    !value_slide_.active)
   {
-    prev_menu_selection = menu.maybe_selected_index;
+    prev_menu_selection_ = menu.maybe_selected_index;
     return;
   }
   const bool partial_redraw = !has_state_changed && !has_menu_changed;
 
   if (use_large_ui_)
   {
-    if (menu_slide_.active)
+    // The new item is drawn once and scrolled in by the screen, which moves the old one out by itself.
+    // Decrement -> we are moving to the next item on list (which is on the right), so everything is moving from the
+    // right to the left.
+    const bool is_sliding = menu_slide_.active;
+    const bool is_slide_from_right = menu_slide_.dir == IncrementDir::decrement;
+    if (is_sliding)
     {
-      const unsigned long anim_start = millis();
-
-      constexpr uint16_t bar_height_px = 56;
-      constexpr uint16_t top_bar_width_px = 5;
-      uint16_t height_option_top_px = 0;
-      uint16_t height_top_bar_px = bar_height_px;
-
-      if (selected_menu_ != OptionMenuScreen::main)
-      {
-        height_top_bar_px += bar_height_px;
-        height_option_top_px = bar_height_px;
-      }
-
-      const uint32_t label_ver = (bar_height_px - medium_font_.get_height_px()) / 2 + height_option_top_px;
-      const uint32_t v_top_y =
-        ((LCD_HEIGHT - height_top_bar_px) / 2 + height_top_bar_px) - large_font_.get_height_px() / 2;
-
-      while (true)
-      {
-        const uint32_t elapsed = millis() - anim_start;
-        float progress = static_cast<float>(elapsed) / static_cast<float>(slice_duration_ms);
-        if (progress > 1.0f)
-        {
-          progress = 1.0f;
-        }
-
-        int old_offset, new_offset;
-        // Decrement -> we are moving to the next item on list (which is on the right)
-        // So everything is moving from the right to the left.
-        if (menu_slide_.dir == IncrementDir::decrement)
-        {
-          old_offset = -static_cast<int>(progress * LCD_WIDTH);
-          new_offset = static_cast<int>((1.0f - progress) * LCD_WIDTH);
-        }
-        else
-        {
-          old_offset = static_cast<int>(progress * LCD_WIDTH);
-          new_offset = -static_cast<int>((1.0f - progress) * LCD_WIDTH);
-        }
-
-        display.draw_rectangle(0, height_option_top_px, LCD_WIDTH, height_top_bar_px, BLACK_COLOR);
-        display.draw_rectangle(0, height_top_bar_px - top_bar_width_px, LCD_WIDTH, height_top_bar_px, WHITE_COLOR);
-
-        display.draw_rectangle(0, v_top_y, LCD_WIDTH, v_top_y + large_font_.get_height_px(), BLACK_COLOR);
-
-        auto draw_menu_title = [&display, &label_ver, &v_top_y, this](const auto maybe_item, const auto offset)
-        {
-          if (offset + static_cast<int>(LCD_WIDTH) > 0 && offset < static_cast<int>(LCD_WIDTH))
-          {
-            if (maybe_item)
-            {
-              const auto& item = maybe_item.value().get();
-              // const auto maybe_label = string_format_option(old_menu.option, false);
-              draw_string_fast(
-                display, item.type != MenuItemType::text ? item.label : "ABOUT", offset, label_ver, offset + LCD_WIDTH, medium_font_, true, false);
-
-              // Draw currently selected option
-              const auto maybe_label = string_format_option(item.option, false);
-              if (maybe_label)
-              {
-                draw_string_fast(
-                      display, item.type != MenuItemType::text ? maybe_label.value() : "", offset, v_top_y, offset + LCD_WIDTH, large_font_, true, false);
-              }
-            }
-          }
-        };
-        draw_menu_title(menu_slide_.maybe_old_item, old_offset);
-        draw_menu_title(menu_slide_.maybe_new_item, new_offset);
-
-        // Don't blip if we reach the end of the animation, because we will immediately blip afterware
-        if (progress >= 1.0f)
-        {
-          menu_slide_.active = false;
-          value_slide_.active = false;
-          break;
-        }
-        display.blip_framebuffer();
-      }
+      menu_slide_.active = false;
+      stop_value_slide();
     }
 
-
     const auto& maybe_menu_item = menu.try_get_selected_item();
     if (!maybe_menu_item)
     {
@@ -522,10 +537,22 @@ void OptionsView::draw_menu(Display& display, const bool has_state_changed)
 
     if (has_menu_changed)
     {
-      // Checkerboard dissolve: blacken every other pixel, blip once (~200ms),
-      // then clear and draw the new menu.
-      display.checkerboard_dissolve();
-      display.blip_framebuffer();
+      // Checkerboard dissolve: blacken every other pixel, the new menu is drawn from scratch once the dissolved frame
+      // has been shown.
+      stop_value_slide();
+      display.start_checkerboard_dissolve();
+      return;
+    }
+
+    // While the value slides, only its band of the screen is drawn again
+    if (value_slide_.maybe_new_surface && !has_state_changed && !on_button_press_)
+    {
+      if (!draw_value_slide(display, value_slide_.top_y_text))
+      {
+        const char* value_str = string_format_option(menu_item.option, /*is_focus =*/false).value_or("ERR");
+        draw_string_fast(display, value_str, 0, value_slide_.top_y_text, LCD_WIDTH, large_font_, true, false);
+      }
+      return;
     }
 
     display.clear_screen(BLACK_COLOR);
@@ -642,59 +669,9 @@ void OptionsView::draw_menu(Display& display, const bool has_state_changed)
       {
         const uint32_t top_y_text = y_center_black_zone - large_font_.get_height_px() / 2;
         // Draw a field label and values
-        if (value_slide_.active)
+        if (draw_value_slide(display, top_y_text))
         {
-          const unsigned long anim_start = millis();
-          while (true)
-          {
-            const uint32_t elapsed = millis() - anim_start;
-            float progress = static_cast<float>(elapsed) / slice_duration_ms;
-            if (progress > 1.0f)
-            {
-              progress = 1.0f;
-            }
-
-            const int old_offset = value_slide_.dir == IncrementDir::increment ? -static_cast<int>(progress * LCD_WIDTH)
-                                                                               : static_cast<int>(progress * LCD_WIDTH);
-            const int new_offset = value_slide_.dir == IncrementDir::increment
-                                     ? static_cast<int>((1.0f - progress) * LCD_WIDTH)
-                                     : -static_cast<int>((1.0f - progress) * LCD_WIDTH);
-
-            display.draw_rectangle(0, top_y_text, LCD_WIDTH, top_y_text + large_font_.get_height_px(), BLACK_COLOR);
-
-            if (old_offset + static_cast<int>(LCD_WIDTH) > 0 && old_offset < static_cast<int>(LCD_WIDTH))
-            {
-              draw_string_fast(
-                display,
-                value_slide_.old_text,
-                old_offset,
-                top_y_text,
-                old_offset + LCD_WIDTH,
-                large_font_,
-                true,
-                false);
-            }
-            if (new_offset + static_cast<int>(LCD_WIDTH) > 0 && new_offset < static_cast<int>(LCD_WIDTH))
-            {
-              draw_string_fast(
-                display,
-                value_slide_.new_text,
-                new_offset,
-                top_y_text,
-                new_offset + LCD_WIDTH,
-                large_font_,
-                true,
-                false);
-            }
-
-            display.blip_framebuffer();
-
-            if (progress >= 1.0f)
-            {
-              value_slide_.active = false;
-              break;
-            }
-          }
+          break;
         }
 
         const char* value_str = string_format_option(menu_item.option, /*is_focus =*/false).value_or("ERR");
@@ -704,17 +681,21 @@ void OptionsView::draw_menu(Display& display, const bool has_state_changed)
       case MenuItemType::enum_length:
         break;
     }
+
+    if (is_sliding)
+    {
+      display.start_scroll_in(is_slide_from_right, slice_duration_ms);
+    }
   }
   else
   {
 
     if (has_menu_changed)
     {
-      // Checkerboard dissolve: blacken every other pixel, blip once (~200ms),
-      // then clear and draw the new menu.
-      display.checkerboard_dissolve();
-      display.blip_framebuffer();
-      display.clear_screen(BLACK_COLOR);
+      // Checkerboard dissolve: blacken every other pixel, the new menu is drawn from scratch once the dissolved frame
+      // has been shown.
+      display.start_checkerboard_dissolve();
+      return;
     }
 
     const uint32_t ver_spacing = font_.get_height_px() + 8;
@@ -733,7 +714,7 @@ void OptionsView::draw_menu(Display& display, const bool has_state_changed)
         break;
       }
 
-      const auto is_prev_selected = prev_menu_selection && i == prev_menu_selection.value();
+      const auto is_prev_selected = prev_menu_selection_ && i == prev_menu_selection_.value();
       const auto is_selected = menu.maybe_selected_index && i == menu.maybe_selected_index.value();
       const auto& label_str = item.label;
 
@@ -768,7 +749,7 @@ void OptionsView::draw_menu(Display& display, const bool has_state_changed)
       }
     }
   }
-  prev_menu_selection = menu.maybe_selected_index;
+  prev_menu_selection_ = menu.maybe_selected_index;
 }
 
 std::optional<const char*> OptionsView::string_format_option(const Option& option, const bool is_focus)
@@ -4,6 +4,7 @@
 #include "draw_primitives.h"
 #include "option_enums.h"
 #include "options_controller.h"
+#include "surface.h"
 
 #include <functional>
 #include <optional>
@@ -70,6 +71,10 @@ public:
 private:
   void draw_menu(Display& display, const bool has_state_changed);
   void draw_volume(Display& display, const bool has_state_changed);
+  /// Draw the step of the value slide due at this frame over the value's band of the screen. Returns false when there
+  /// is no slide or it's over, the value is then drawn as is.
+  bool draw_value_slide(Display& display, const uint32_t top_y_text);
+  void stop_value_slide();
   Menu& get_selected_menu();
   std::optional<const char*> string_format_option(const Option& option, const bool is_focus);
 
@@ -103,6 +108,14 @@ private:
   // Force partial redraw on button press
   bool on_button_press_{false};
 
+  // What draw_volume() and draw_menu() drew last, set on their first call
+  std::optional<int32_t> maybe_prev_volume_;
+  std::optional<OptionMenuScreen> maybe_prev_selected_menu_;
+  std::optional<size_t> prev_menu_selection_;
+  // The volume stays on screen for this long after it changed
+  constexpr static int max_time_since_last_change_ = 5000;
+  int time_since_last_change_{-max_time_since_last_change_};
+
   // Page counter buffer (reused each frame)
   char page_count_buffer_[12];
 
@@ -130,6 +143,11 @@ private:
     char old_text[50];
     // The new text value doesn't need to be copied
     const char* new_text{nullptr};
+    // Set by the first frame of the slide: each value is rasterized once, the following frames only copy its pixels
+    std::optional<Surface> maybe_old_surface;
+    std::optional<Surface> maybe_new_surface;
+    unsigned long start_ms{0};
+    uint32_t top_y_text{0};
   };
   ValueSlideState value_slide_{};
 
@@ -0,0 +1,86 @@
+#ifndef PACKED_FILL_GUARD_H_
+#define PACKED_FILL_GUARD_H_
+
+#include <stdint.h>
+#include <string.h>
+
+// Word-wide kernels for the packed RGB444 framebuffer (2 pixels in 3 bytes).
+// A pair of pixels is 3 bytes, so 4 pairs are exactly three 32-bit words: once the destination is aligned on 4 bytes,
+// a repeated 3 bytes pattern is written 8 pixels at a time with three word stores.
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "The packed words are built for a little endian CPU");
+
+/// Apply `op(dst, value)` to `pair_count` groups of 3 bytes starting at `dst`, with `value` cycling through b0, b1, b2.
+/// `op` is called on single bytes for the unaligned head and the tail, and on 32-bit words for the bulk. The words are
+/// loaded and stored with memcpy(), which doesn't break strict aliasing and compiles to single ldr/str once aligned.
+template <typename Op>
+inline void apply_packed_pairs(
+  uint8_t* dst, uint32_t pair_count, const uint8_t b0, const uint8_t b1, const uint8_t b2, const Op& op)
+{
+  auto apply_pair = [&](uint8_t*& ptr)
+  {
+    op(ptr[0], b0);
+    op(ptr[1], b1);
+    op(ptr[2], b2);
+    ptr += 3;
+  };
+
+  // Each pair moves the address by 3 bytes, so at most 3 pairs are needed to reach a 4 bytes boundary
+  while ((reinterpret_cast<uintptr_t>(dst) & 3) != 0 && pair_count > 0)
+  {
+    apply_pair(dst);
+    --pair_count;
+  }
+
+  // The 12 bytes pattern b0 b1 b2 b0 | b1 b2 b0 b1 | b2 b0 b1 b2 as little endian words
+  const uint32_t w0 = b0 | (b1 << 8) | (b2 << 16) | (static_cast<uint32_t>(b0) << 24);
+  const uint32_t w1 = b1 | (b2 << 8) | (b0 << 16) | (static_cast<uint32_t>(b1) << 24);
+  const uint32_t w2 = b2 | (b0 << 8) | (b1 << 16) | (static_cast<uint32_t>(b2) << 24);
+  auto apply_word = [&](uint8_t* ptr, const uint32_t pattern)
+  {
+    uint32_t word;
+    memcpy(&word, ptr, sizeof(word));
+    op(word, pattern);
+    memcpy(ptr, &word, sizeof(word));
+  };
+  if (pair_count >= 4)
+  {
+    dst = static_cast<uint8_t*>(__builtin_assume_aligned(dst, 4));
+  }
+  for (uint32_t i = pair_count / 4; i > 0; --i)
+  {
+    apply_word(dst, w0);
+    apply_word(dst + 4, w1);
+    apply_word(dst + 8, w2);
+    dst += 12;
+  }
+
+  switch (pair_count % 4)
+  {
+    case 3:
+      apply_pair(dst);
+      [[fallthrough]];
+    case 2:
+      apply_pair(dst);
+      [[fallthrough]];
+    case 1:
+      apply_pair(dst);
+      break;
+    default:
+      break;
+  }
+}
+
+/// Write `pair_count` times the 3 bytes b0, b1, b2 starting at `dst`
+inline void fill_packed_pairs(uint8_t* dst, const uint32_t pair_count, const uint8_t b0, const uint8_t b1, const uint8_t b2)
+{
+  apply_packed_pairs(dst, pair_count, b0, b1, b2, [](auto& value, const auto pattern) { value = pattern; });
+}
+
+/// AND `pair_count` groups of 3 bytes starting at `dst` with the mask m0, m1, m2
+inline void mask_packed_pairs(uint8_t* dst, const uint32_t pair_count, const uint8_t m0, const uint8_t m1, const uint8_t m2)
+{
+  apply_packed_pairs(dst, pair_count, m0, m1, m2, [](auto& value, const auto mask) { value &= mask; });
+}
+
+#endif  // PACKED_FILL_GUARD_H_
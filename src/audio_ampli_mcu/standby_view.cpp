@@ -1,7 +1,6 @@
 #include "standby_view.h"
 
 #include <algorithm>
-#include <cmath>
 
 namespace
 {
@@ -11,24 +10,25 @@ namespace
   constexpr uint32_t BREATH_HOLD_MS = 1500;
   constexpr int16_t Z_SPAWN_OFFSET_X = 100;
   constexpr int16_t Z_SPAWN_OFFSET_Y = 5;
-  constexpr float Z_RISE_SPEED_PPS = 18.0f;
-  constexpr float Z_DRIFT_RIGHT_PPS = 8.0f;
-  constexpr float Z_DRIFT_AMPLITUDE = 10.0f;
-  constexpr float Z_DRIFT_FREQ = 2.5f;
+  constexpr fixed_t Z_RISE_SPEED_PPS = int_to_fixed(18);
+  constexpr fixed_t Z_DRIFT_RIGHT_PPS = int_to_fixed(8);
+  constexpr fixed_t Z_DRIFT_AMPLITUDE = int_to_fixed(10);
+  // 2.5 rad/s, in turns per second
+  constexpr fixed_t Z_DRIFT_FREQ = float_to_fixed(2.5f / 6.2831853f);
 
   constexpr uint32_t grayscale_color(const uint32_t intensity_4bit)
   {
     return (intensity_4bit << 8) | (intensity_4bit << 4) | intensity_4bit;
   }
 
-  // Simple pseudo-random using bit-mixed millis. Returns [0.0, 1.0).
-  float random_float(const uint32_t seed)
+  // Simple pseudo-random using bit-mixed millis. Returns [0, fixed_one).
+  fixed_t random_fixed(const uint32_t seed)
   {
     // xorshift-ish bit mixing
     uint32_t x = seed * 747796405u + 2891336453u;
     x = ((x >> ((x >> 28) + 4)) ^ x) * 277803737u;
     x = (x >> 22) ^ x;
-    return static_cast<float>(x) / 4294967296.0f;
+    return static_cast<fixed_t>(x >> 16);
   }
 }
 
@@ -36,7 +36,7 @@ StandbyView::StandbyView(
   StateMachine& state_machine,
   Display& display,
   const LvFontWrapper& font,
-  const lv_img_dsc_t& cat_image)
+  const rgb444_img_dsc_t& cat_image)
   : state_machine_(state_machine)
   , display_(display)
   , font_(font)
@@ -148,10 +148,10 @@ void StandbyView::draw(const bool has_state_changed)
 
         // Randomize this particle's personality
         const uint32_t seed = now + static_cast<uint32_t>(i * 137);
-        z.drift_phase = random_float(seed) * 6.283f;           // 0 to 2π
-        z.drift_amp = 0.5f + random_float(seed + 1) * 1.0f;    // 0.5 to 1.5
-        z.rise_speed_mult = 1.0f; //0.7f + random_float(seed + 2) * 0.6f;  // 0.7 to 1.3
-        z.right_drift_mult = 0.5f + random_float(seed + 3) * 1.0f;   // 0.5 to 1.5
+        z.drift_phase = random_fixed(seed);                         // 0 to 1 turn
+        z.drift_amp = fixed_one / 2 + random_fixed(seed + 1);       // 0.5 to 1.5
+        z.rise_speed_mult = fixed_one; //float_to_fixed(0.7f) + fixed_mul(random_fixed(seed + 2), float_to_fixed(0.6f));  // 0.7 to 1.3
+        z.right_drift_mult = fixed_one / 2 + random_fixed(seed + 3);  // 0.5 to 1.5
         break;
       }
     }
@@ -182,12 +182,13 @@ void StandbyView::draw(const bool has_state_changed)
     }
 
     // Compute new position with per-particle variation
-    const float age_sec = static_cast<float>(age) / 1000.0f;
-    const float rise = Z_RISE_SPEED_PPS * z.rise_speed_mult * age_sec;
-    const float right = Z_DRIFT_RIGHT_PPS * z.right_drift_mult * age_sec;
-    const float sway = Z_DRIFT_AMPLITUDE * z.drift_amp * sinf(age_sec * Z_DRIFT_FREQ + z.drift_phase);
-    z.x = z.spawn_x + static_cast<int16_t>(right + sway);
-    z.y = z.spawn_y - static_cast<int16_t>(rise);
+    const fixed_t age_sec = fixed_ratio(age, 1000);
+    const fixed_t rise = fixed_mul(fixed_mul(Z_RISE_SPEED_PPS, z.rise_speed_mult), age_sec);
+    const fixed_t right = fixed_mul(fixed_mul(Z_DRIFT_RIGHT_PPS, z.right_drift_mult), age_sec);
+    const fixed_t sway = fixed_mul(
+      fixed_mul(Z_DRIFT_AMPLITUDE, z.drift_amp), fixed_sin(fixed_mul(age_sec, Z_DRIFT_FREQ) + z.drift_phase));
+    z.x = z.spawn_x + static_cast<int16_t>(fixed_to_int(right + sway));
+    z.y = z.spawn_y - static_cast<int16_t>(fixed_to_int(rise));
 
     // Compute fade color: white -> gray -> black over second half of life
     uint32_t z_color = WHITE_COLOR;
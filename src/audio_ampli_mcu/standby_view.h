@@ -2,6 +2,7 @@
 #define STANDBY_VIEW_GUARD_H_
 
 #include "draw_primitives.h"
+#include "fixed_point.h"
 #include "state_machine.h"
 
 class StandbyView
@@ -11,7 +12,7 @@ public:
     StateMachine& state_machine,
     Display& display,
     const LvFontWrapper& font,
-    const lv_img_dsc_t& cat_image);
+    const rgb444_img_dsc_t& cat_image);
 
   void draw(const bool has_state_changed);
 
@@ -29,10 +30,10 @@ private:
     bool has_been_drawn{false};
 
     // Per-particle random variation
-    float drift_phase{0.0f};      // Random sine phase offset
-    float drift_amp{1.0f};        // Random amplitude multiplier
-    float rise_speed_mult{1.0f};  // Random rise speed multiplier
-    float right_drift_mult{1.0f}; // Random rightward drift multiplier
+    fixed_t drift_phase{0};                // Random sine phase offset, in turns
+    fixed_t drift_amp{fixed_one};          // Random amplitude multiplier
+    fixed_t rise_speed_mult{fixed_one};    // Random rise speed multiplier
+    fixed_t right_drift_mult{fixed_one};   // Random rightward drift multiplier
   };
 
   static constexpr int MAX_Z_COUNT = 6;
@@ -41,7 +42,7 @@ private:
   Display& display_;
 
   const LvFontWrapper& font_;
-  const lv_img_dsc_t& cat_image_;
+  const rgb444_img_dsc_t& cat_image_;
 
   int16_t cat_x_ = 0;
   int16_t cat_y_ = 0;
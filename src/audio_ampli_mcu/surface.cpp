@@ -0,0 +1,35 @@
+#include "surface.h"
+
+#include "packed_fill.h"
+
+#include <cstdlib>
+
+Surface::Surface(const Rect& bounds) : bounds_(bounds)
+{
+  bounds_.clip_to_screen();
+  bounds_.x_start &= ~1;
+  // LCD_WIDTH is even, rounding up stays on the screen
+  bounds_.x_end = (bounds_.x_end + 1) & ~1;
+  if (bounds_.is_empty())
+  {
+    return;
+  }
+  data_ = static_cast<uint8_t*>(malloc(bounds_.area() * 3 / 2));
+}
+
+Surface::~Surface()
+{
+  free(data_);
+}
+
+void Surface::fill(const uint32_t color_12bit)
+{
+  if (data_ == nullptr)
+  {
+    return;
+  }
+  const uint8_t byte0 = (color_12bit >> 4) & 0xff;
+  const uint8_t byte1 = ((color_12bit & 0xf) << 4) | ((color_12bit & 0x0f00) >> 8);
+  const uint8_t byte2 = color_12bit & 0xff;
+  fill_packed_pairs(data_, bounds_.area() / 2, byte0, byte1, byte2);
+}
@@ -0,0 +1,35 @@
+#ifndef SURFACE_GUARD_H_
+#define SURFACE_GUARD_H_
+
+#include "LCD_Driver.h"
+
+#include <stdint.h>
+
+/// Offscreen image in the framebuffer's format (RGB444, 2 pixels packed in 3 bytes) covering a rectangle of the screen.
+/// Something drawn once into a surface with Display::begin_offscreen() can then be blitted at any offset, which only
+/// costs a copy of its pixels.
+class Surface
+{
+public:
+  /// The bounds are extended to whole pixel pairs, so a blit at an even offset copies the rows with memcpy. The memory
+  /// comes from the heap, check is_valid().
+  explicit Surface(const Rect& bounds);
+  ~Surface();
+  Surface(const Surface&) = delete;
+  Surface& operator=(const Surface&) = delete;
+
+  bool is_valid() const { return data_ != nullptr; }
+  /// Rectangle of the screen held by the surface, the drawing calls use screen coordinates
+  const Rect& bounds() const { return bounds_; }
+  /// Pixels of the surface, the rows follow each other without padding
+  uint8_t* data() { return data_; }
+  const uint8_t* data() const { return data_; }
+  /// Fill the whole surface with one color, Display::clear_screen() only works on the screen
+  void fill(const uint32_t color_12bit);
+
+private:
+  Rect bounds_;
+  uint8_t* data_{nullptr};
+};
+
+#endif  // SURFACE_GUARD_H_
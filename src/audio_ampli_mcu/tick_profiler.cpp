@@ -0,0 +1,81 @@
+#include "tick_profiler.h"
+
+#ifdef PROFILE_TICK
+#include <algorithm>
+#ifdef SIM
+#include "sim/arduino.h"
+#else
+#include <Arduino.h>
+#endif
+
+namespace
+{
+constexpr const char* stage_names[] = {"decode_command", "interaction", "volume", "draw", "flash_save", "blip"};
+static_assert(sizeof(stage_names) / sizeof(stage_names[0]) == static_cast<size_t>(TickStage::count));
+}  // namespace
+
+void TickProfiler::begin(const TickStage stage)
+{
+  start_us_[static_cast<uint8_t>(stage)] = micros();
+}
+
+void TickProfiler::end(const TickStage stage)
+{
+  const uint8_t i = static_cast<uint8_t>(stage);
+  samples_us_[i][sample_idx_[i]] = micros() - start_us_[i];
+  sample_idx_[i] = (sample_idx_[i] + 1) % samples_per_stage;
+  if (sample_count_[i] < samples_per_stage)
+  {
+    ++sample_count_[i];
+  }
+}
+
+void TickProfiler::poll_report()
+{
+  bool is_requested = false;
+  while (Serial.available() > 0)
+  {
+    is_requested |= Serial.read() == 'p';
+  }
+  if (is_requested || millis() - last_report_ms_ > report_interval_ms)
+  {
+    report();
+    last_report_ms_ = millis();
+  }
+}
+
+void TickProfiler::report()
+{
+  for (uint8_t i = 0; i < stage_count; ++i)
+  {
+    const uint16_t count = sample_count_[i];
+    if (count == 0)
+    {
+      continue;
+    }
+    // Sorting a copy keeps the ring buffer in order of arrival
+    uint32_t sorted_us[samples_per_stage];
+    std::copy(samples_us_[i], samples_us_[i] + count, sorted_us);
+    std::sort(sorted_us, sorted_us + count);
+    uint32_t total_us = 0;
+    for (uint16_t j = 0; j < count; ++j)
+    {
+      total_us += sorted_us[j];
+    }
+
+    Serial.print("Tick ");
+    Serial.print(stage_names[i]);
+    Serial.print(": min ");
+    Serial.print(static_cast<int>(sorted_us[0]));
+    Serial.print("us avg ");
+    Serial.print(static_cast<int>(total_us / count));
+    Serial.print("us p99 ");
+    Serial.print(static_cast<int>(sorted_us[(count - 1) * 99 / 100]));
+    Serial.print("us max ");
+    Serial.print(static_cast<int>(sorted_us[count - 1]));
+    Serial.print("us over ");
+    Serial.print(static_cast<int>(count));
+    Serial.println(" calls");
+  }
+}
+#endif
@@ -0,0 +1,55 @@
+#ifndef TICK_PROFILER_GUARD_H_
+#define TICK_PROFILER_GUARD_H_
+
+#include "config.h"
+
+#include <stdint.h>
+
+/// Stages of App::tick() timed by the profiler
+enum class TickStage : uint8_t
+{
+  decode_command = 0,
+  interaction,
+  volume,
+  draw,
+  flash_save,
+  blip,
+  count
+};
+
+#ifdef PROFILE_TICK
+/// Keeps the duration of the last calls of each stage in a ring buffer, and prints their min, avg, p99 and max over
+/// Serial periodically or when 'p' is received. Each App holds its own, use it through the PROFILE_TICK_* macros in the
+/// methods of App, they compile to nothing without PROFILE_TICK.
+class TickProfiler
+{
+public:
+  void begin(const TickStage stage);
+  void end(const TickStage stage);
+  /// Print the report when it's due or asked for over Serial
+  void poll_report();
+  void report();
+
+  /// Durations kept per stage, the report covers the last ones
+  static constexpr uint16_t samples_per_stage = 128;
+  static constexpr uint32_t report_interval_ms = 5000;
+
+private:
+  static constexpr uint8_t stage_count = static_cast<uint8_t>(TickStage::count);
+  uint32_t start_us_[stage_count] = {0};
+  uint32_t samples_us_[stage_count][samples_per_stage] = {{0}};
+  uint16_t sample_idx_[stage_count] = {0};
+  uint16_t sample_count_[stage_count] = {0};
+  uint32_t last_report_ms_{0};
+};
+
+#define PROFILE_TICK_BEGIN(stage) tick_profiler_.begin(stage)
+#define PROFILE_TICK_END(stage) tick_profiler_.end(stage)
+#define PROFILE_TICK_POLL_REPORT() tick_profiler_.poll_report()
+#else
+#define PROFILE_TICK_BEGIN(stage)
+#define PROFILE_TICK_END(stage)
+#define PROFILE_TICK_POLL_REPORT()
+#endif
+
+#endif  // TICK_PROFILER_GUARD_H_
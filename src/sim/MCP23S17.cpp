@@ -3,6 +3,7 @@
 #include "audio_ampli_mcu/pinout_config.h"
 #include "sim/arduino.h"
 #include "sim/sim_config.h"
+#include "sim/spi_bus_model.h"
 
 #include <cassert>
 #include <cstdint>
@@ -38,8 +39,33 @@ void MCP23S17::enableHardwareAddress()
 
 }
 
+namespace
+{
+/// Default SPI clock of the library, the MCP23S17 supports up to 10MHz
+constexpr uint32_t spi_clock_hz = 8000000;
+}  // namespace
+
+void MCP23S17::time_register_access()
+{
+  spi_bus_begin_transaction(SpiDevice::io_expander, spi_clock_hz);
+  spi_bus_write_pin(SpiDevice::io_expander);
+  // One SPI.transfer() per byte
+  for (int i = 0; i < 3; ++i)
+  {
+    spi_bus_transfer(SpiDevice::io_expander, 1);
+  }
+  spi_bus_write_pin(SpiDevice::io_expander);
+}
+
 bool MCP23S17::begin(bool pullup)
 {
+  // Configuration register, then the pull-ups of both ports
+  time_register_access();
+  if (pullup)
+  {
+    time_register_access();
+    time_register_access();
+  }
   return true;
 }
 
@@ -49,6 +75,7 @@ bool MCP23S17::write8(uint8_t port, uint8_t value)
   // Serial.print("> Send write8 port=");
   // Serial.println(port);
   assert(port < 2);
+  time_register_access();
 
   const auto& my_pin = pin_out::l_volume_bit0;
   if (my_pin.module == gpio_module_ && (my_pin.port == GpioPort::a ? 0 : 1) == port)
@@ -73,6 +100,9 @@ bool MCP23S17::write8(uint8_t port, uint8_t value)
 
 bool MCP23S17::setInterruptPolarity(uint8_t polarity)
 {
+  // Read-modify-write of the configuration register
+  time_register_access();
+  time_register_access();
 #ifdef HAS_PHONO_CARD
   polarity_ = polarity;
 #else
@@ -86,12 +116,14 @@ bool MCP23S17::setInterruptPolarity(uint8_t polarity)
 
 uint8_t MCP23S17::getInterruptPolarity()
 {
+  time_register_access();
   return polarity_;
 }
 
 bool MCP23S17::pinMode8(uint8_t port, uint8_t value)
 {
   assert(port < 2);
+  time_register_access();
   if (port < 2)
   {
     // Serial.print(static_cast<uint8_t>(gpio_module_));
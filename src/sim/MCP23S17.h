@@ -25,6 +25,8 @@ public:
 
 private:
   void print_status();
+  /// Time the SPI transaction of the library on the bus model: chip select, opcode, register and value
+  void time_register_access();
 
   uint8_t chip_select_;
   uint8_t address_;
@@ -1,18 +1,21 @@
-
 #include "sim/RP2040_PWM.h"
 
-#include <iostream>
+#include "sim/hal_context.h"
 
 RP2040_PWM::RP2040_PWM(const uint8_t& pin, const float& frequency, const float dutycycle, bool phaseCorrect)
-  : duty_cycle_(dutycycle)
 {
 }
 bool RP2040_PWM::setPWM(const uint8_t& pin, const float& frequency, const float dutycycle, bool phaseCorrect)
 {
-  if (dutycycle != duty_cycle_)
+  if (pin >= HalContext::gpio_count)
+  {
+    return false;
+  }
+  auto& maybe_duty_cycle = hal_context().gpios[pin].maybe_pwm_duty_cycle;
+  if (maybe_duty_cycle && *maybe_duty_cycle != dutycycle)
   {
-    std::cout << "Changed duty cycle from " << duty_cycle_ << " to " << dutycycle << std::endl;
+    *hal_context().serial << "Changed duty cycle from " << *maybe_duty_cycle << " to " << dutycycle << std::endl;
   }
-  duty_cycle_ = dutycycle;
+  maybe_duty_cycle = dutycycle;
   return true;
-}
\ No newline at end of file
+}
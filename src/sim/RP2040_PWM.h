@@ -3,13 +3,11 @@
 
 #include "sim/arduino.h"
 
+/// Stateless, the duty cycle of the pin is kept in the HalContext of the calling thread
 class RP2040_PWM
 {
 public:
   RP2040_PWM(const uint8_t& pin, const float& frequency, const float dutycycle, bool phaseCorrect = false);
   bool setPWM(const uint8_t& pin, const float& frequency, const float dutycycle, bool phaseCorrect = false);
-
-private:
-  float duty_cycle_;
 };
 #endif
\ No newline at end of file
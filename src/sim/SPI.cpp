@@ -1,9 +1,14 @@
-#include "sim/spi.h"
+#include "sim/SPI.h"
+#include "sim/arduino.h"
+#include "sim/hal_context.h"
 #include "sim/lcd_simulator.h"
+#include "sim/spi_bus_model.h"
+
+#include <algorithm>
 
 SPIClass SPI;
 
-SPISettings::SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+SPISettings::SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) : clock_(clock)
 {
 }
 
@@ -30,18 +35,59 @@ void SPIClass::endTransaction()
 
 void SPIClass::transfer(const void* txbuf_, void* rxbuf, size_t count)
 {
-  const uint8_t* txbuf = reinterpret_cast<const uint8_t*>(txbuf_);
-  for (size_t i = 0; i < count; ++i)
+  spi_bus_transfer(SpiDevice::lcd, count);
+  LCD_process_spi_buffer(reinterpret_cast<const uint8_t*>(txbuf_), count);
+}
+
+bool SPIClass::transferAsync(const void* send, void* recv, size_t bytes)
+{
+  HalContext::SpiAsync& async = hal_context().spi_async;
+  if (async.buf != nullptr)
+  {
+    return false;
+  }
+  async.buf = reinterpret_cast<const uint8_t*>(send);
+  async.len = bytes;
+  async.sent = 0;
+  spi_bus_start_dma(SpiDevice::lcd, bytes);
+  async.start_us = micros();
+  return true;
+}
+
+bool SPIClass::finishedAsync()
+{
+  HalContext::SpiAsync& async = hal_context().spi_async;
+  if (async.buf == nullptr)
+  {
+    return true;
+  }
+  // Send the bytes that the DMA would have sent by now
+  const size_t target = std::min(async.len, spi_bus_dma_bytes_sent(micros() - async.start_us));
+  if (target > async.sent)
+  {
+    LCD_process_spi_buffer(async.buf + async.sent, target - async.sent);
+    async.sent = target;
+  }
+  if (async.sent < async.len)
   {
-    LCD_process_spi_data(txbuf[i]);
+    return false;
   }
+  async.buf = nullptr;
+  return true;
+}
+
+void SPIClass::abortAsync()
+{
+  hal_context().spi_async.buf = nullptr;
 }
 
 void SPIClass::transfer(const uint8_t& data)
 {
+  spi_bus_transfer(SpiDevice::lcd, 1);
   LCD_process_spi_data(data);
 }
 
 void SPIClass::beginTransaction(SPISettings settings)
 {
+  spi_bus_begin_transaction(SpiDevice::lcd, settings.clock_);
 }
\ No newline at end of file
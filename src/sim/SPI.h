@@ -20,9 +20,12 @@ class SPISettings
 {
 public:
   SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode);
+
+  uint32_t clock_;
 };
 
-/// Mock of the RP2040 SPI class. All transfers are forwarded to the LCD simulator
+/// Mock of the RP2040 SPI class. All transfers are forwarded to the LCD simulator, and timed by the SPI bus model. The
+/// DMA transfer in progress is held by the HalContext of the calling thread.
 class SPIClass
 {
 public:
@@ -33,6 +36,11 @@ public:
   void begin(bool hwCS);
   void transfer(const uint8_t& data);
   void transfer(const void* txbuf, void* rxbuf, size_t count);
+  /// The bytes are forwarded to the LCD simulator over time (as the DMA would) on each call to finishedAsync(), the
+  /// buffer must stay untouched until then.
+  bool transferAsync(const void* send, void* recv, size_t bytes);
+  bool finishedAsync();
+  void abortAsync();
   void beginTransaction(SPISettings settings);
   void endTransaction();
 };
@@ -1,22 +1,18 @@
 #include "sim/arduino.h"
 
-#include <SDL.h>
+#include "audio_ampli_mcu/pinout_config.h"
+#include "sim/hal_context.h"
+#include "sim/sim_clock.h"
+#include "sim/spi_bus_model.h"
+
 #include <fstream>
 #include <iostream>
-
-#define GPIO_COUNT 28
+#include <sys/ioctl.h>
+#include <unistd.h>
 
 SerialObject Serial;
 EEPROMClass EEPROM;
 
-struct Gpio
-{
-  int direction{INPUT};
-  int value{LOW};
-};
-
-Gpio gpios[GPIO_COUNT] = {};
-
 long map(long x, long in_min, long in_max, long out_min, long out_max)
 {
   return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
@@ -24,37 +20,46 @@ long map(long x, long in_min, long in_max, long out_min, long out_max)
 
 void pinMode(int pin, int input_output)
 {
-  if (pin >= 0 && pin < GPIO_COUNT)
+  if (pin >= 0 && pin < HalContext::gpio_count)
   {
-    gpios[pin].direction = input_output;
+    hal_context().gpios[pin].direction = input_output;
   }
 }
 
 void digitalWrite(int pin, int input_output)
 {
-  if (pin >= 0 && pin < GPIO_COUNT)
+  if (pin >= 0 && pin < HalContext::gpio_count)
+  {
+    hal_context().gpios[pin].value = input_output;
+  }
+  if (pin == pin_out::lcd_chip_select.pin || pin == pin_out::lcd_dc.pin)
   {
-    gpios[pin].value = input_output;
+    spi_bus_write_pin(SpiDevice::lcd);
   }
 }
 
 int digitalRead(int pin)
 {
-  if (pin >= 0 && pin < GPIO_COUNT)
+  if (pin >= 0 && pin < HalContext::gpio_count)
   {
-    return gpios[pin].value;
+    return hal_context().gpios[pin].value;
   }
   return 0;
 }
 
 unsigned long millis()
 {
-  return static_cast<unsigned long>(SDL_GetTicks());
+  return static_cast<unsigned long>(sim_clock_millis());
+}
+
+unsigned long micros()
+{
+  return static_cast<unsigned long>(sim_clock_micros());
 }
 
 void delay(const int ms)
 {
-  SDL_Delay(ms);
+  sim_clock_wait_us(static_cast<uint64_t>(ms) * 1000);
 }
 
 bool SerialObject::begin(int baudrate)
@@ -63,11 +68,11 @@ bool SerialObject::begin(int baudrate)
 }
 void SerialObject::print(const char* text)
 {
-  std::cout << text << std::flush;
+  *hal_context().serial << text << std::flush;
 }
 void SerialObject::print(const int number)
 {
-  std::cout << std::to_string(number) << std::flush;
+  *hal_context().serial << std::to_string(number) << std::flush;
 }
 
 // void SerialObject::print(const int32_t number)
@@ -82,57 +87,82 @@ void SerialObject::print(const int number)
 
 void SerialObject::println(const int number)
 {
-  std::cout << std::to_string(number) << std::endl;
+  *hal_context().serial << std::to_string(number) << std::endl;
+}
+
+int SerialObject::available()
+{
+  // A closed stdin has nothing to read, instead of being always readable
+  int byte_count = 0;
+  return ioctl(STDIN_FILENO, FIONREAD, &byte_count) == 0 ? byte_count : 0;
+}
+
+int SerialObject::read()
+{
+  if (available() == 0)
+  {
+    return -1;
+  }
+  char c;
+  return ::read(STDIN_FILENO, &c, 1) == 1 ? c : -1;
 }
 
 void SerialObject::println(const char* text)
 {
-  std::cout << text << std::endl;
+  *hal_context().serial << text << std::endl;
 }
 
 void delayMicroseconds(const unsigned us)
 {
+  // Too short to sleep on the wall clock, the virtual clock still counts it
+  if (sim_clock_is_virtual())
+  {
+    sim_clock_wait_us(us);
+  }
 }
 
 void EEPROMClass::begin(size_t size)
 {
-  if (_data != nullptr)
-  {
-    delete[] _data;
-  }
-  _data = new uint8_t[size];
-  _size = size;
+  HalContext& context = hal_context();
+  context.eeprom.assign(size, 0);
 
-  Serial.println("Reading to flash_data.bin...");
-  std::ifstream fs("flash_data.bin", std::ios::in | std::ios::binary);
-  fs.read(reinterpret_cast<char*>(_data), _size);
+  Serial.print("Reading to ");
+  Serial.print(context.flash_path.c_str());
+  Serial.println("...");
+  std::ifstream fs(context.flash_path, std::ios::in | std::ios::binary);
+  fs.read(reinterpret_cast<char*>(context.eeprom.data()), context.eeprom.size());
   fs.close();
 }
 
 uint8_t EEPROMClass::read(int const address)
 {
-  if (address < 0 || (size_t)address >= _size)
-  {
-    return 0;
-  }
-  if (!_data)
+  const uint8_t* data = range(address, 1);
+  if (data == nullptr)
   {
     return 0;
   }
 
-  return _data[address];
+  return *data;
 }
 
 bool EEPROMClass::commit()
 {
-  Serial.println("Writting to flash_data.bin...");
-  std::ofstream fs("flash_data.bin", std::ios::out | std::ios::binary);
-  fs.write(reinterpret_cast<const char*>(_data), _size);
+  HalContext& context = hal_context();
+  Serial.print("Writting to ");
+  Serial.print(context.flash_path.c_str());
+  Serial.println("...");
+  std::ofstream fs(context.flash_path, std::ios::out | std::ios::binary);
+  fs.write(reinterpret_cast<const char*>(context.eeprom.data()), context.eeprom.size());
   fs.close();
   return true;
 }
 
-EEPROMClass::~EEPROMClass()
+uint8_t* EEPROMClass::range(int const address, const size_t size)
 {
-  delete[] _data;
+  std::vector<uint8_t>& eeprom = hal_context().eeprom;
+  if (address < 0 || static_cast<size_t>(address) + size > eeprom.size())
+  {
+    return nullptr;
+  }
+  return eeprom.data() + address;
 }
\ No newline at end of file
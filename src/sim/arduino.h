@@ -19,6 +19,7 @@ void digitalWrite(int pin, int input_output);
 void delayMicroseconds(const unsigned us);
 
 unsigned long millis();
+unsigned long micros();
 void delay(const int ms);
 
 #define HIGH 0x1
@@ -27,6 +28,7 @@ void delay(const int ms);
 #define INPUT 0x0
 #define OUTPUT 0x1
 
+/// Prints to the stream of the HalContext of the calling thread, stdout by default
 class SerialObject
 {
 public:
@@ -37,46 +39,52 @@ public:
   void println(const char* text);
   void println(const int number);
   // void println(const uint32_t number);
+  /// Number of bytes typed on stdin which can be read without blocking
+  int available();
+  /// Next byte typed on stdin, -1 if there is none
+  int read();
 };
 
+/// The flash content is held by the HalContext of the calling thread, and saved to its flash_path
 class EEPROMClass
 {
 public:
   void begin(size_t size);
   uint8_t read(int const address);
   bool commit();
-  ~EEPROMClass();
 
   template <typename T>
   T& get(int const address, T& t)
   {
-    if (address < 0 || address + sizeof(T) > _size)
+    const uint8_t* data = range(address, sizeof(T));
+    if (data == nullptr)
     {
       return t;
     }
 
-    memcpy((uint8_t*)&t, _data + address, sizeof(T));
+    memcpy((uint8_t*)&t, data, sizeof(T));
     return t;
   }
 
   template <typename T>
   const T& put(int const address, const T& t)
   {
-    if (address < 0 || address + sizeof(T) > _size)
+    uint8_t* data = range(address, sizeof(T));
+    if (data == nullptr)
     {
       return t;
     }
-    if (memcmp(_data + address, (const uint8_t*)&t, sizeof(T)) != 0)
+    if (memcmp(data, (const uint8_t*)&t, sizeof(T)) != 0)
     {
-      memcpy(_data + address, (const uint8_t*)&t, sizeof(T));
+      memcpy(data, (const uint8_t*)&t, sizeof(T));
     }
 
     return t;
   }
 
 private:
-  uint8_t* _data = nullptr;
-  size_t _size = 0;
+  /// The `size` bytes at `address`, null if they aren't all in the flash
+  uint8_t* range(int const address, const size_t size);
 };
 
 extern SerialObject Serial;
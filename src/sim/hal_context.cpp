@@ -0,0 +1,32 @@
+#include "sim/hal_context.h"
+
+#include <memory>
+
+namespace
+{
+thread_local std::unique_ptr<HalContext> default_context;
+thread_local HalContext* bound_context = nullptr;
+}  // namespace
+
+HalContext& hal_context()
+{
+  if (bound_context == nullptr)
+  {
+    if (!default_context)
+    {
+      default_context = std::make_unique<HalContext>();
+    }
+    bound_context = default_context.get();
+  }
+  return *bound_context;
+}
+
+HalContextBinding::HalContextBinding(HalContext& context) : previous_context_(bound_context)
+{
+  bound_context = &context;
+}
+
+HalContextBinding::~HalContextBinding()
+{
+  bound_context = previous_context_;
+}
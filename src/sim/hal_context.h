@@ -0,0 +1,163 @@
+#ifndef HAL_CONTEXT_GUARD_H_
+#define HAL_CONTEXT_GUARD_H_
+
+#include "audio_ampli_mcu/LCD_Driver.h"
+#include "sim/spi_bus_model.h"
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+// forward declaration
+class SDL_Surface;
+
+/// Everything the simulated hardware of one instance of the app holds: clock, pins, encoders, buttons, SPI bus, screen
+/// and flash. The simulated functions (millis(), digitalRead(), SPI, Serial, EEPROM...) work on the context bound to
+/// the calling thread, and each thread gets its own by default. Several instances of the app can then run in parallel,
+/// as long as each one has its own thread and its own App.
+struct HalContext
+{
+  struct Clock
+  {
+    bool is_virtual_time{false};
+    uint64_t virtual_time_us{0};
+  };
+
+  struct Gpio
+  {
+    int direction{INPUT};
+    int value{LOW};
+    /// Duty cycle set by RP2040_PWM, none until the first setPWM()
+    std::optional<float> maybe_pwm_duty_cycle;
+  };
+
+  struct Button
+  {
+    bool state{false};
+    int when_press_ms{0};
+    int when_released_ms{0};
+  };
+
+  /// The panel and its SPI decoding (lcd_simulator.cpp)
+  struct Lcd
+  {
+    SDL_Surface* surface{nullptr};
+    std::function<void(void)> blip_window_callback;
+    /// Pixels written since the window was last refreshed
+    uint64_t pixel_count{0};
+    uint32_t win_start_x{0};
+    uint32_t win_start_y{0};
+    uint32_t win_end_x{0};
+    uint32_t win_end_y{0};
+    uint32_t win_curr_x{0};
+    uint32_t win_curr_y{0};
+    /// Panel memory, the surface shows it through the scroll
+    uint16_t gram[LCD_HEIGHT][LCD_WIDTH] = {{0}};
+    /// Scroll definition in panel lines, which are our columns in reverse order (MADCTL MY|MV)
+    uint32_t scroll_top_fixed_lines{0};
+    uint32_t scroll_area_lines{LCD_WIDTH};
+    uint32_t scroll_start_line{0};
+    /// Last command received and its parameters so far
+    std::optional<uint8_t> maybe_command;
+    std::vector<uint8_t> spi_data;
+  };
+
+  /// DMA transfer of SPI.transferAsync() (SPI.cpp)
+  struct SpiAsync
+  {
+    const uint8_t* buf{nullptr};
+    size_t len{0};
+    size_t sent{0};
+    uint64_t start_us{0};
+  };
+
+  /// Timing of the SPI bus (spi_bus_model.cpp)
+  struct SpiBus
+  {
+    struct DeviceStats
+    {
+      uint64_t busy_ns{0};
+      uint64_t byte_count{0};
+    };
+    /// Bus time of the ticks or frames since the last report
+    struct PeriodStats
+    {
+      uint32_t count{0};
+      uint64_t total_ns{0};
+      uint64_t max_ns{0};
+    };
+
+    /// arduino-pico's default settings, until the first transaction
+    uint32_t clock_hz{spi_bus_effective_clock_hz(4000000)};
+    uint32_t dma_clock_hz{clock_hz};
+    bool is_transfer_time_simulated{true};
+    /// Predicted time not waited yet, the clock only waits by steps of its resolution
+    uint64_t pending_wait_ns{0};
+    DeviceStats device_stats[static_cast<size_t>(SpiDevice::count)];
+    uint64_t tick_busy_ns{0};
+    uint64_t frame_busy_ns{0};
+    PeriodStats tick_stats;
+    PeriodStats frame_stats;
+    uint64_t last_report_us{0};
+  };
+
+  /// Pixel writes counted by overdraw_profiler.cpp
+  struct Overdraw
+  {
+    struct ViewStats
+    {
+      const char* name;
+      uint64_t write_count{0};
+      /// Writes to a pixel already written in the same frame
+      uint64_t overwrite_count{0};
+    };
+
+    /// Writes of each pixel in the current frame, saturated at 255
+    uint8_t frame_counts[LCD_HEIGHT][LCD_WIDTH] = {{0}};
+    bool has_frame_writes{false};
+    /// Writes of each pixel in the last frame which wrote anything
+    uint8_t heatmap_counts[LCD_HEIGHT][LCD_WIDTH] = {{0}};
+    std::vector<ViewStats> view_stats;
+    size_t current_view{0};
+  };
+
+  static constexpr int gpio_count = 28;
+  /// Encoders and buttons are indexed by their pin
+  static constexpr int input_pin_count = 40;
+
+  Clock clock;
+  Gpio gpios[gpio_count];
+  int encoder_counts[input_pin_count] = {0};
+  Button buttons[input_pin_count];
+  Lcd lcd;
+  SpiAsync spi_async;
+  SpiBus spi_bus;
+  Overdraw overdraw;
+  /// Content of the flash emulated by EEPROM, loaded from and saved to flash_path
+  std::vector<uint8_t> eeprom;
+  std::string flash_path{"flash_data.bin"};
+  /// Where Serial prints
+  std::ostream* serial{&std::cout};
+};
+
+/// Context bound to the calling thread, its own default one unless a HalContextBinding is alive
+HalContext& hal_context();
+
+/// Bind `context` to the calling thread until the binding is destroyed, to set up the hardware of an instance before
+/// running it or to look at it afterwards. The context is large, allocate it on the heap.
+class HalContextBinding
+{
+public:
+  explicit HalContextBinding(HalContext& context);
+  ~HalContextBinding();
+  HalContextBinding(const HalContextBinding&) = delete;
+  HalContextBinding& operator=(const HalContextBinding&) = delete;
+
+private:
+  HalContext* previous_context_;
+};
+
+#endif  // HAL_CONTEXT_GUARD_H_
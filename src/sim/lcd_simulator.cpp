@@ -2,35 +2,29 @@
 
 #include "audio_ampli_mcu/LCD_Driver.h"
 #include "sim/arduino.h"
+#include "sim/hal_context.h"
 
 #include <SDL.h>
+#include <array>
 #include <cassert>
+#include <cstring>
+#include <initializer_list>
 #include <iostream>
-#include <optional>
-#include <tuple>
 
-/// It's around 1.33us/px in theory with 20MHz, 10bit per bytes and 2 px per 3 bytes, in practive it's 1us/px
-constexpr uint64_t pixel_per_ms = 997;
-uint64_t pixel_count = 0;
-
-SDL_Surface* global_surface = nullptr;
-uint32_t win_start_x = 0;
-uint32_t win_start_y = 0;
-uint32_t win_end_x = 0;
-uint32_t win_end_y = 0;
-uint32_t win_curr_x = 0;
-uint32_t win_curr_y = 0;
-
-std::function<void(void)> blip_sdl_window_callback = nullptr;
+/// The window is refreshed after this many pixels, about every ms of transfer, so the pushes can be seen going. The
+/// time taken by the transfer is predicted by the SPI bus model.
+constexpr uint64_t pixels_per_window_update = 1000;
 
 void hook_sdl_surface_for_lcd_simulator(SDL_Surface* surface, std::function<void(void)> funct)
 {
-  global_surface = surface;
-  blip_sdl_window_callback = funct;
+  HalContext::Lcd& lcd = hal_context().lcd;
+  lcd.surface = surface;
+  lcd.blip_window_callback = funct;
 }
 
-std::tuple<uint8_t, uint8_t, uint8_t> rgb444_to_rgb888(const uint32_t color_12bit)
-{
+/// The 4096 colors expanded to the bytes of the surface, BGR due to little endianness, so a pixel is converted with a
+/// single lookup
+const auto rgb444_to_bgr888 = [] {
   auto map_4b_to_8bit = [](const uint32_t v) -> uint8_t {
     if (v == 0xf)
     {
@@ -38,103 +32,168 @@ std::tuple<uint8_t, uint8_t, uint8_t> rgb444_to_rgb888(const uint32_t color_12bi
     }
     return v << 4;
   };
-  const auto r = map_4b_to_8bit((color_12bit >> 8) & 0xf);
-  const auto g = map_4b_to_8bit((color_12bit >> 4) & 0xf);
-  const auto b = map_4b_to_8bit((color_12bit >> 0) & 0xf);
-  return std::make_tuple(r, g, b);
+  std::array<std::array<uint8_t, 3>, 4096> table{};
+  for (uint32_t color_12bit = 0; color_12bit < table.size(); ++color_12bit)
+  {
+    table[color_12bit] = {
+      map_4b_to_8bit((color_12bit >> 0) & 0xf),
+      map_4b_to_8bit((color_12bit >> 4) & 0xf),
+      map_4b_to_8bit((color_12bit >> 8) & 0xf)};
+  }
+  return table;
+}();
+
+/// Column of the screen where the column x of the panel memory is shown
+uint32_t scrolled_x(const HalContext::Lcd& lcd, const uint32_t x)
+{
+  const uint32_t line = LCD_WIDTH - 1 - x;
+  if (line < lcd.scroll_top_fixed_lines || line >= lcd.scroll_top_fixed_lines + lcd.scroll_area_lines)
+  {
+    return x;
+  }
+  // The first line of the scroll area shows the line lcd.scroll_start_line, the following ones wrap inside the area
+  const uint32_t shown_line =
+    lcd.scroll_top_fixed_lines +
+    (line + lcd.scroll_area_lines - lcd.scroll_start_line % lcd.scroll_area_lines) % lcd.scroll_area_lines;
+  return LCD_WIDTH - 1 - shown_line;
+}
+
+void draw_pixel_to_sdl_surface(
+  const HalContext::Lcd& lcd, const uint32_t x, const uint32_t y, const uint32_t color12bit)
+{
+  SDL_Surface* const surface = lcd.surface;
+  const uint32_t max_offset = surface->pitch * (LCD_HEIGHT - 1) + (LCD_WIDTH - 1) * surface->format->BytesPerPixel;
+  const uint32_t offset = y * surface->pitch + x * surface->format->BytesPerPixel;
+  if (offset >= max_offset)
+  {
+    return;
+  }
+  uint8_t* const target_pixel = ((uint8_t*)surface->pixels + offset);
+
+  memcpy(target_pixel, rgb444_to_bgr888[color12bit & 0xfff].data(), 3);
 }
 
-void write_2pixel_color_to_sdl_surface(const uint32_t color_2pixels)
+void write_2pixel_color_to_sdl_surface(HalContext::Lcd& lcd, const uint32_t color_2pixels)
 {
-  if (win_curr_y >= win_end_y)
+  if (lcd.win_curr_y >= lcd.win_end_y)
   {
     return;
   }
   const uint32_t left_pixel_color = (color_2pixels >> 12) & 0xFFF;
   const uint32_t right_pixel_color = (color_2pixels >> 0) & 0xFFF;
-  const uint32_t max_offset =
-    global_surface->pitch * (LCD_HEIGHT - 1) + (LCD_WIDTH - 1) * global_surface->format->BytesPerPixel;
 
-  auto sdl_draw_pixel = [&max_offset](const uint32_t x, const uint32_t y, const uint32_t color12bit) {
-    const uint32_t offset = y * global_surface->pitch + x * global_surface->format->BytesPerPixel;
-    if (offset >= max_offset)
+  auto sdl_draw_pixel = [&lcd](const uint32_t x, const uint32_t y, const uint32_t color12bit) {
+    if (x < LCD_WIDTH && y < LCD_HEIGHT)
     {
-      return;
+      lcd.gram[y][x] = color12bit;
     }
-    uint8_t* const target_pixel = ((uint8_t*)global_surface->pixels + offset);
-
-    const auto [r, g, b] = rgb444_to_rgb888(color12bit);
-    // Due to little endianness it's BGR, not RGB
-    target_pixel[0] = b;
-    target_pixel[1] = g;
-    target_pixel[2] = r;
+    draw_pixel_to_sdl_surface(lcd, scrolled_x(lcd, x), y, color12bit);
   };
-  sdl_draw_pixel(win_curr_x, win_curr_y, left_pixel_color);
-  sdl_draw_pixel(win_curr_x + 1, win_curr_y, right_pixel_color);
-  win_curr_x += 2;
-  if (win_curr_x >= win_end_x)
+  // The screen wraps to the next row of the window after each pixel, so windows with an odd width work too
+  for (const auto color12bit : {left_pixel_color, right_pixel_color})
   {
-    win_curr_x = win_start_x;
-    ++win_curr_y;
+    if (lcd.win_curr_y >= lcd.win_end_y)
+    {
+      break;
+    }
+    sdl_draw_pixel(lcd.win_curr_x, lcd.win_curr_y, color12bit);
+    ++lcd.win_curr_x;
+    if (lcd.win_curr_x >= lcd.win_end_x)
+    {
+      lcd.win_curr_x = lcd.win_start_x;
+      ++lcd.win_curr_y;
+    }
+  }
+
+  lcd.pixel_count += 2;
+  if (lcd.pixel_count >= pixels_per_window_update)
+  {
+    lcd.pixel_count = 0;
+    lcd.blip_window_callback();
   }
+}
 
-  pixel_count += 2;
-  if (pixel_count > pixel_per_ms)
+void LCD_set_column_address(HalContext::Lcd& lcd)
+{
+  if (lcd.spi_data.size() != 4)
   {
-    SDL_Delay(pixel_count / pixel_per_ms);
-    pixel_count = 0;
-    blip_sdl_window_callback();
+    return;
   }
+  lcd.win_start_x = (lcd.spi_data[0] << 8) | lcd.spi_data[1];
+  lcd.win_end_x = (lcd.spi_data[2] << 8) | lcd.spi_data[3];
+  ++lcd.win_end_x;
+  lcd.win_curr_x = lcd.win_start_x;
+
+  assert(lcd.win_start_x <= lcd.win_end_x);
+  assert(lcd.win_end_x <= LCD_WIDTH);
 }
 
-// State of the SPI processing
-std::optional<uint8_t> maybe_command;
-std::vector<uint8_t> spi_data;
+void LCD_set_row_address(HalContext::Lcd& lcd)
+{
+  if (lcd.spi_data.size() != 4)
+  {
+    return;
+  }
+  lcd.win_start_y = (lcd.spi_data[0] << 8) | lcd.spi_data[1];
+  lcd.win_end_y = (lcd.spi_data[2] << 8) | lcd.spi_data[3];
+  ++lcd.win_end_y;
+  lcd.win_curr_y = lcd.win_start_y;
 
-void LCD_set_column_address()
+  assert(lcd.win_start_y <= lcd.win_end_y);
+  assert(lcd.win_end_y <= LCD_HEIGHT);
+}
+
+void LCD_set_scroll_definition(HalContext::Lcd& lcd)
 {
-  if (spi_data.size() != 4)
+  if (lcd.spi_data.size() != 6)
   {
     return;
   }
-  win_start_x = (spi_data[0] << 8) | spi_data[1];
-  win_end_x = (spi_data[2] << 8) | spi_data[3];
-  ++win_end_x;
-  win_curr_x = win_start_x;
+  lcd.scroll_top_fixed_lines = (lcd.spi_data[0] << 8) | lcd.spi_data[1];
+  lcd.scroll_area_lines = (lcd.spi_data[2] << 8) | lcd.spi_data[3];
+  const uint32_t bottom_fixed_lines = (lcd.spi_data[4] << 8) | lcd.spi_data[5];
+  lcd.spi_data.clear();
 
-  assert(win_start_x <= win_end_x);
-  assert(win_end_x <= LCD_WIDTH);
+  assert(lcd.scroll_area_lines > 0);
+  assert(lcd.scroll_top_fixed_lines + lcd.scroll_area_lines + bottom_fixed_lines == LCD_WIDTH);
 }
 
-void LCD_set_row_address()
+void LCD_set_scroll_start(HalContext::Lcd& lcd)
 {
-  if (spi_data.size() != 4)
+  if (lcd.spi_data.size() != 2)
   {
     return;
   }
-  win_start_y = (spi_data[0] << 8) | spi_data[1];
-  win_end_y = (spi_data[2] << 8) | spi_data[3];
-  ++win_end_y;
-  win_curr_y = win_start_y;
+  lcd.scroll_start_line = (lcd.spi_data[0] << 8) | lcd.spi_data[1];
+  lcd.spi_data.clear();
 
-  assert(win_start_y <= win_end_y);
-  assert(win_end_y <= LCD_HEIGHT);
+  assert(lcd.scroll_start_line < LCD_WIDTH);
+  // The whole screen moves without any pixel being sent
+  for (uint32_t y = 0; y < LCD_HEIGHT; ++y)
+  {
+    for (uint32_t x = 0; x < LCD_WIDTH; ++x)
+    {
+      draw_pixel_to_sdl_surface(lcd, scrolled_x(lcd, x), y, lcd.gram[y][x]);
+    }
+  }
+  lcd.blip_window_callback();
 }
 
-void LCD_write_mem()
+void LCD_write_mem(HalContext::Lcd& lcd)
 {
-  if (spi_data.size() != 3)
+  if (lcd.spi_data.size() != 3)
   {
     return;
   }
 
-  const uint32_t color_2pixel = (spi_data[0] << 16) | (spi_data[1] << 8) | (spi_data[2] << 0);
-  write_2pixel_color_to_sdl_surface(color_2pixel);
-  spi_data.clear();
+  const uint32_t color_2pixel = (lcd.spi_data[0] << 16) | (lcd.spi_data[1] << 8) | (lcd.spi_data[2] << 0);
+  write_2pixel_color_to_sdl_surface(lcd, color_2pixel);
+  lcd.spi_data.clear();
 }
 
 void LCD_process_spi_data(const uint8_t data)
 {
+  HalContext::Lcd& lcd = hal_context().lcd;
   // Skip if no chip select
   if (digitalRead(pin_out::lcd_chip_select.pin) == 1)
   {
@@ -144,29 +203,59 @@ void LCD_process_spi_data(const uint8_t data)
   // Is command?
   if (digitalRead(pin_out::lcd_dc.pin) == 0)
   {
-    if (maybe_command && maybe_command.value() != data)
+    if (lcd.maybe_command && lcd.maybe_command.value() != data)
     {
-      spi_data.clear();
+      lcd.spi_data.clear();
     }
-    maybe_command = data;
+    lcd.maybe_command = data;
     return;
   }
-  if (!maybe_command)
+  if (!lcd.maybe_command)
   {
     return;
   }
-  spi_data.push_back(data);
-  // Only process set window and write to screen commands
-  switch (maybe_command.value())
+  lcd.spi_data.push_back(data);
+  // Only process set window, write to screen and scroll commands
+  switch (lcd.maybe_command.value())
   {
     case LCD_REG_COL_ADDR_SET:
-      LCD_set_column_address();
+      LCD_set_column_address(lcd);
       break;
     case LCD_REG_ROW_ADDR_SET:
-      LCD_set_row_address();
+      LCD_set_row_address(lcd);
       break;
     case LCD_REG_MEM_WRITE:
-      LCD_write_mem();
+      LCD_write_mem(lcd);
       break;
+    case LCD_REG_VSCRDEF:
+      LCD_set_scroll_definition(lcd);
+      break;
+    case LCD_REG_VSCSAD:
+      LCD_set_scroll_start(lcd);
+      break;
+  }
+}
+
+void LCD_process_spi_buffer(const uint8_t* data, const size_t count)
+{
+  HalContext::Lcd& lcd = hal_context().lcd;
+  size_t i = 0;
+  const bool is_pixel_data = digitalRead(pin_out::lcd_chip_select.pin) == 0 &&
+                             digitalRead(pin_out::lcd_dc.pin) == 1 && lcd.maybe_command == LCD_REG_MEM_WRITE;
+  if (is_pixel_data)
+  {
+    // Complete the pixel pair started by a previous transfer, if any
+    for (; i < count && !lcd.spi_data.empty(); ++i)
+    {
+      LCD_process_spi_data(data[i]);
+    }
+    for (; i + 3 <= count; i += 3)
+    {
+      write_2pixel_color_to_sdl_surface(lcd, (data[i] << 16) | (data[i + 1] << 8) | (data[i + 2] << 0));
+    }
+  }
+  for (; i < count; ++i)
+  {
+    LCD_process_spi_data(data[i]);
   }
 }
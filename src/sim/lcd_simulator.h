@@ -1,14 +1,19 @@
 #ifndef __LCD_SIM_H
 #define __LCD_SIM_H
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 
 // forward declaration
 class SDL_Surface;
 
+/// Show the screen of the HalContext of the calling thread on `surface`, `funct` is called to refresh the window
 void hook_sdl_surface_for_lcd_simulator(SDL_Surface* surface, std::function<void(void)> funct);
 
 void LCD_process_spi_data(const uint8_t data);
+/// Same as LCD_process_spi_data() for each byte of `data`, the pixels sent to LCD_REG_MEM_WRITE skip the byte by byte
+/// decoding and go straight to the surface
+void LCD_process_spi_buffer(const uint8_t* data, const size_t count);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "audio_ampli_mcu/LCD_Driver.h"
+#include "audio_ampli_mcu/cat_sleep_img.h"
+#include "audio_ampli_mcu/digit_font.h"
+#include "audio_ampli_mcu/digit_font_droid_sans_mono_130.h"
+#include "audio_ampli_mcu/dm_sans_bold_62.h"
+#include "audio_ampli_mcu/dm_sans_extrabold.h"
+#include "audio_ampli_mcu/dm_sans_regular_40.h"
+#include "audio_ampli_mcu/draw_primitives.h"
+#include "audio_ampli_mcu/left_arrow_img.h"
+#include "audio_ampli_mcu/mute_img.h"
+#include "sim/lcd_simulator.h"
+#include "sim/spi_bus_model.h"
+
+#include <SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+
+// Microbenchmarks of the drawing primitives and the transition steps, drawn into the framebuffer of a Display without
+// window. Each benchmark is warmed up, then timed over several repetitions; the median is printed so a regression
+// shows up as a number instead of a feeling.
+namespace
+{
+constexpr int warmup_ms = 20;
+constexpr int repetition_count = 15;
+/// A repetition runs the operation enough times to last at least this long, so the clock resolution doesn't matter
+constexpr uint64_t min_repetition_ns = 2000000;
+
+Display display;
+
+constexpr LvFontWrapper digit_droid_sans_font(&digit_font_droid_sans_mono_130, true);
+constexpr LvFontWrapper digit_light_font(&dmsans_36pt_light, true);
+constexpr LvFontWrapper regular_bold_font(&dmsans_36pt_extrabold);
+constexpr LvFontWrapper regular_medium_font(&dmsans_36pt_regular_40);
+constexpr LvFontWrapper regular_large_font(&dm_sans_bold_62);
+
+uint64_t now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+void print_result(const char* name, const uint64_t px_per_op, uint64_t* ns_per_op)
+{
+  std::sort(ns_per_op, ns_per_op + repetition_count);
+  const uint64_t median_ns = ns_per_op[repetition_count / 2];
+  printf("%-36s %12llu ns/op %12llu min", name, static_cast<unsigned long long>(median_ns),
+    static_cast<unsigned long long>(ns_per_op[0]));
+  if (px_per_op > 0 && median_ns > 0)
+  {
+    printf(" %10.1f Mpx/s", static_cast<double>(px_per_op) * 1000.0 / static_cast<double>(median_ns));
+  }
+  printf("\n");
+}
+
+/// Time `op`, which writes `px_per_op` pixels (0 when unknown)
+template <typename Op>
+void bench(const char* name, const uint64_t px_per_op, Op op)
+{
+  // Warm up the caches and find how many operations last long enough
+  uint64_t batch = 1;
+  const uint64_t warmup_end_ns = now_ns() + warmup_ms * 1000000ull;
+  while (true)
+  {
+    const uint64_t start_ns = now_ns();
+    for (uint64_t i = 0; i < batch; ++i)
+    {
+      op();
+    }
+    const uint64_t end_ns = now_ns();
+    if (end_ns - start_ns >= min_repetition_ns && end_ns >= warmup_end_ns)
+    {
+      break;
+    }
+    if (end_ns - start_ns < min_repetition_ns)
+    {
+      batch *= 2;
+    }
+  }
+
+  uint64_t ns_per_op[repetition_count];
+  for (int r = 0; r < repetition_count; ++r)
+  {
+    const uint64_t start_ns = now_ns();
+    for (uint64_t i = 0; i < batch; ++i)
+    {
+      op();
+    }
+    ns_per_op[r] = (now_ns() - start_ns) / batch;
+  }
+  print_result(name, px_per_op, ns_per_op);
+}
+
+/// Time `op` alone, `setup` is run before each call of `op` and isn't timed. For the steps of a transition, which
+/// must be started first.
+template <typename Setup, typename Op>
+void bench_step(const char* name, const uint64_t px_per_op, Setup setup, Op op)
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    setup();
+    op();
+  }
+  uint64_t ns_per_op[repetition_count];
+  for (int r = 0; r < repetition_count; ++r)
+  {
+    setup();
+    const uint64_t start_ns = now_ns();
+    op();
+    ns_per_op[r] = now_ns() - start_ns;
+  }
+  print_result(name, px_per_op, ns_per_op);
+}
+
+void bench_font(const char* font_name, const LvFontWrapper& font, const char glyph_char, const char* str)
+{
+  char name[64];
+  if (const auto maybe_glyph = font.get_glyph(glyph_char); maybe_glyph)
+  {
+    const LvFontWrapper::LvGlyph* glyph = maybe_glyph.value();
+    snprintf(name, sizeof(name), "glyph '%c' %s", glyph_char, font_name);
+    bench(name, glyph->width_with_spacing_px * glyph->height_px, [glyph] {
+      draw_character_fast(display, glyph, 20, 20);
+    });
+  }
+  snprintf(name, sizeof(name), "string \"%s\" %s", str, font_name);
+  bench(name, get_string_width_px(str, font) * font.get_height_px(), [str, &font] {
+    draw_string_fast(display, str, 0, 20, LCD_WIDTH, font);
+  });
+}
+}  // namespace
+
+int main(int argc, char* args[])
+{
+  // The pushes, if any, go to a surface without window
+  SDL_Surface* screen_surface = SDL_CreateRGBSurface(0, LCD_WIDTH, LCD_HEIGHT, 32, 0, 0, 0, 0);
+  if (screen_surface == nullptr)
+  {
+    return -1;
+  }
+  hook_sdl_surface_for_lcd_simulator(screen_surface, [] {});
+  spi_bus_simulate_transfer_time(false);
+
+  printf("--- fills\n");
+  bench("clear_screen", LCD_WIDTH * LCD_HEIGHT, [] { display.clear_screen(BLACK_COLOR); });
+  bench("draw_rectangle 100x50", 100 * 50, [] { display.draw_rectangle(10, 10, 110, 60, WHITE_COLOR); });
+  bench("draw_rectangle 8x8", 8 * 8, [] { display.draw_rectangle(11, 11, 19, 19, WHITE_COLOR); });
+  bench("draw_rectangle row 320x1", LCD_WIDTH, [] { display.draw_rectangle(0, 100, LCD_WIDTH, 101, WHITE_COLOR); });
+  bench("draw_rectangle column 1x240", LCD_HEIGHT, [] {
+    display.draw_rectangle(101, 0, 102, LCD_HEIGHT, WHITE_COLOR);
+  });
+  bench("set_pixel", 1, [] { display.set_pixel(101, 57, WHITE_COLOR); });
+
+  printf("--- glyphs and strings\n");
+  bench_font("digits 130", digit_droid_sans_font, '8', "-12.5");
+  bench_font("light 36", digit_light_font, '8', "-12.5 dB");
+  bench_font("bold 36", regular_bold_font, 'A', "Phono MM");
+  bench_font("medium 40", regular_medium_font, 'A', "Phono MM");
+  bench_font("large 62", regular_large_font, 'A', "Phono MM");
+
+  printf("--- images\n");
+  bench("image cat 224x136", cat_sleep_image.w_px * cat_sleep_image.h_px, [] {
+    draw_image_from_top_left(display, cat_sleep_image, 50, 50);
+  });
+  bench("image cat 224x136 odd x", cat_sleep_image.w_px * cat_sleep_image.h_px, [] {
+    draw_image_from_top_left(display, cat_sleep_image, 51, 50);
+  });
+  bench("image cat 224x136 mirrored", cat_sleep_image.w_px * cat_sleep_image.h_px, [] {
+    draw_image_from_top_left(display, cat_sleep_image, 50, 50, true);
+  });
+  bench("image mute 188x149", mute_image.w_px * mute_image.h_px, [] {
+    draw_image_from_top_left(display, mute_image, 50, 50);
+  });
+  bench("image arrow 32x32", left_arrow_image.w_px * left_arrow_image.h_px, [] {
+    draw_image_from_top_left(display, left_arrow_image, 50, 50);
+  });
+
+  printf("--- rounded rectangles\n");
+  bench("rounded_rectangle 200x60", 200 * 60, [] {
+    draw_rounded_rectangle(display, 20, 20, 220, 80, true, true, true);
+  });
+  bench("rounded_rectangle 200x60 outline", 200 * 60, [] {
+    draw_rounded_rectangle(display, 20, 20, 220, 80, false, true, true);
+  });
+  bench("rounded_rectangle 40x30 left", 40 * 30, [] {
+    draw_rounded_rectangle(display, 20, 20, 60, 50, true, true, false);
+  });
+
+  printf("--- transition steps\n");
+  // Something to transition away from
+  auto draw_screen = [] {
+    display.finish_transition();
+    display.clear_screen(BLACK_COLOR);
+    draw_image_from_top_left(display, cat_sleep_image, 50, 50);
+  };
+  bench_step("checkerboard_dissolve", LCD_WIDTH * LCD_HEIGHT, draw_screen, [] {
+    display.start_checkerboard_dissolve();
+  });
+  bench_step("melt first step", 0, [&draw_screen] {
+    draw_screen();
+    display.start_melt();
+  }, [] { display.advance_transition(); });
+  bench_step("melt finish", 0, [&draw_screen] {
+    draw_screen();
+    display.start_melt();
+  }, [] { display.finish_transition(); });
+  bench_step("roto_zoom start", 0, draw_screen, [] { display.start_roto_zoom(); });
+  bench_step("roto_zoom frame", LCD_WIDTH * LCD_HEIGHT, [&draw_screen] {
+    draw_screen();
+    display.start_roto_zoom();
+  }, [] { display.advance_transition(UINT32_MAX); });
+  display.finish_transition();
+
+  SDL_FreeSurface(screen_surface);
+  return 0;
+}
@@ -1,9 +1,13 @@
 #include "audio_ampli_mcu/LCD_Driver.h"
+#include "audio_ampli_mcu/frame_scheduler.h"
 #include "sim/external/gif.h"
 #include "sim/lcd_simulator.h"
+#include "sim/overdraw_profiler.h"
 #include "sim/pio_encoder.h"
+#include "sim/sim_clock.h"
 
 #include <SDL.h>
+#include <cstring>
 #include <stdio.h>
 
 void setup();
@@ -12,11 +16,13 @@ void loop();
 constexpr int delay_between_frame_ms = 1;
 int main(int argc, char* args[])
 {
-  if (argc != 2)
+  if (argc != 2 && argc != 3)
   {
-    printf("Invalid arguments, usage: gif_generator path/to/my_output.gif");
+    printf("Invalid arguments, usage: gif_generator path/to/my_output.gif [path/to/overdraw_heatmap.gif]");
   }
   const char* filename = args[1];
+  // Optional GIF of the same frames with the overdraw heatmap on top
+  const char* heatmap_filename = argc == 3 ? args[2] : nullptr;
   // The window we'll be rendering to
   // SDL_Window* window = NULL;
 
@@ -34,29 +40,57 @@ int main(int argc, char* args[])
   // Fill the surface white
   SDL_FillRect(screenSurface, NULL, SDL_MapRGB(screenSurface->format, 0xFF, 0xFF, 0xFF));
 
+  // The frames only depend on the inputs, not on how long the host takes to draw and encode them
+  sim_clock_use_virtual_time(true);
+
   // Call arduino's setup
   setup();
 
   GifWriter g;
   GifBegin(&g, filename, LCD_WIDTH, LCD_HEIGHT, delay_between_frame_ms * 5);
+  GifWriter heatmap_gif;
+  SDL_Surface* heatmap_surface = nullptr;
+  if (heatmap_filename)
+  {
+    GifBegin(&heatmap_gif, heatmap_filename, LCD_WIDTH, LCD_HEIGHT, delay_between_frame_ms * 5);
+    heatmap_surface = SDL_CreateRGBSurface(0, LCD_WIDTH, LCD_HEIGHT, 32, 0, 0, 0, 0);
+  }
 
+  // The app only draws once a frame is due, wait for it so each loop() gives a frame of the GIF
+  auto draw_next_frame = []() {
+    delay(FrameScheduler::default_frame_interval_ms + 1);
+    loop();
+  };
   auto write_frame = [&](const auto delay) {
     GifWriteFrame(&g, reinterpret_cast<const uint8_t*>(screenSurface->pixels), LCD_WIDTH, LCD_HEIGHT, delay);
+    if (heatmap_surface)
+    {
+      memcpy(heatmap_surface->pixels, screenSurface->pixels, screenSurface->pitch * LCD_HEIGHT);
+      overdraw_draw_heatmap(heatmap_surface);
+      GifWriteFrame(
+        &heatmap_gif, reinterpret_cast<const uint8_t*>(heatmap_surface->pixels), LCD_WIDTH, LCD_HEIGHT, delay);
+    }
   };
   for (size_t i = 0; i < 75; ++i)
   {
-    loop();
+    draw_next_frame();
     write_frame(delay_between_frame_ms);
     decrement_encoder(18, 3);
   }
   write_frame(delay_between_frame_ms * 5);
   for (size_t i = 0; i < 75; ++i)
   {
-    loop();
+    draw_next_frame();
     write_frame(delay_between_frame_ms);
     increment_encoder(18, 3);
   }
   GifEnd(&g);
+  if (heatmap_surface)
+  {
+    GifEnd(&heatmap_gif);
+    SDL_FreeSurface(heatmap_surface);
+  }
+  overdraw_report();
 
   return 0;
 }
@@ -0,0 +1,272 @@
+#include "audio_ampli_mcu/LCD_Driver.h"
+#include "audio_ampli_mcu/app.h"
+#include "sim/hal_context.h"
+#include "sim/lcd_simulator.h"
+#include "sim/pio_encoder.h"
+#include "sim/sim_clock.h"
+#include "sim/spi_bus_model.h"
+#include "sim/toggle_button.h"
+
+#include <SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+void setup();
+void loop();
+
+// Run the app without window on the virtual clock, as fast as the host allows: an hour of inactivity takes seconds.
+// The inputs come from an optional script, one event per line as "<time_s> <command> [argument]":
+//   volume <ticks>         turn the volume encoder, negative to turn it down
+//   menu <ticks>           turn the menu encoder, negative to go up
+//   press mute|select      press a button, until its release
+//   release mute|select
+//   screenshot <file.bmp>  save the screen
+// Empty lines and lines starting with # are skipped.
+// With several scripts, each one runs in its own thread with its own App and simulated hardware. The Serial output
+// and the flash of an instance go to <script>.log and <script>.flash, and the screenshots are taken by each instance.
+namespace
+{
+/// Same tick as the simulator with a window
+constexpr int tick_period_ms = 2;
+
+struct ScriptEvent
+{
+  uint64_t time_ms;
+  std::string command;
+  std::string argument;
+};
+
+/// Pin of the button, 0 if there is no such button
+uint8_t button_pin(const std::string& name)
+{
+  if (name == "mute")
+  {
+    return 16;
+  }
+  if (name == "select")
+  {
+    return 17;
+  }
+  return 0;
+}
+
+bool parse_script(const char* path, std::vector<ScriptEvent>& events)
+{
+  std::ifstream fs(path);
+  if (!fs)
+  {
+    printf("Can't open the script %s\n", path);
+    return false;
+  }
+  std::string line;
+  for (int line_number = 1; std::getline(fs, line); ++line_number)
+  {
+    if (line.empty() || line[0] == '#')
+    {
+      continue;
+    }
+    std::istringstream ss(line);
+    double time_s = 0;
+    ScriptEvent event;
+    ss >> time_s >> event.command >> event.argument;
+    event.time_ms = static_cast<uint64_t>(time_s * 1000);
+    bool is_valid = false;
+    if (event.command == "volume" || event.command == "menu" || event.command == "screenshot")
+    {
+      is_valid = !event.argument.empty();
+    }
+    else if (event.command == "press" || event.command == "release")
+    {
+      is_valid = button_pin(event.argument) != 0;
+    }
+    if (ss.fail() || !is_valid)
+    {
+      printf("Invalid event line %d of %s: %s\n", line_number, path, line.c_str());
+      return false;
+    }
+    events.push_back(event);
+  }
+  std::stable_sort(events.begin(), events.end(), [](const ScriptEvent& a, const ScriptEvent& b) {
+    return a.time_ms < b.time_ms;
+  });
+  return true;
+}
+
+void run_event(const ScriptEvent& event, SDL_Surface* surface)
+{
+  if (event.command == "volume")
+  {
+    increment_encoder(18, std::stoi(event.argument));
+  }
+  else if (event.command == "menu")
+  {
+    increment_encoder(20, std::stoi(event.argument));
+  }
+  else if (event.command == "press")
+  {
+    button_pressed(button_pin(event.argument), false);
+  }
+  else if (event.command == "release")
+  {
+    button_released(button_pin(event.argument));
+  }
+  else if (event.command == "screenshot" && SDL_SaveBMP(surface, event.argument.c_str()) != 0)
+  {
+    printf("Can't save the screenshot %s\n", event.argument.c_str());
+  }
+}
+
+/// Screen of the instance bound to the calling thread, white until the app draws
+SDL_Surface* create_screen()
+{
+  SDL_Surface* surface = SDL_CreateRGBSurface(0, LCD_WIDTH, LCD_HEIGHT, 32, 0, 0, 0, 0);
+  if (surface != nullptr)
+  {
+    hook_sdl_surface_for_lcd_simulator(surface, [] {});
+    SDL_FillRect(surface, nullptr, SDL_MapRGB(surface->format, 0xFF, 0xFF, 0xFF));
+  }
+  return surface;
+}
+
+/// Tick the instance bound to the calling thread until `duration_ms`, running the events when they are due
+void run_script(
+  const uint64_t duration_ms,
+  const std::vector<ScriptEvent>& events,
+  SDL_Surface* surface,
+  const std::function<void(void)>& tick)
+{
+  size_t next_event = 0;
+  while (millis() < duration_ms)
+  {
+    for (; next_event < events.size() && events[next_event].time_ms <= millis(); ++next_event)
+    {
+      run_event(events[next_event], surface);
+    }
+    tick();
+    delay(tick_period_ms);
+  }
+}
+
+struct Instance
+{
+  const char* script_path;
+  std::vector<ScriptEvent> events;
+  std::unique_ptr<HalContext> context{std::make_unique<HalContext>()};
+  std::ofstream serial_log;
+  SDL_Surface* surface{nullptr};
+};
+
+/// Run each script with its own App in its own thread
+int run_instances(const uint64_t duration_ms, const int script_count, char* script_paths[])
+{
+  std::vector<Instance> instances(script_count);
+  for (int i = 0; i < script_count; ++i)
+  {
+    Instance& instance = instances[i];
+    instance.script_path = script_paths[i];
+    if (!parse_script(instance.script_path, instance.events))
+    {
+      return -1;
+    }
+    const std::string path = instance.script_path;
+    instance.serial_log.open(path + ".log");
+    instance.context->serial = &instance.serial_log;
+    instance.context->flash_path = path + ".flash";
+
+    HalContextBinding binding(*instance.context);
+    sim_clock_use_virtual_time(true);
+    instance.surface = create_screen();
+    if (instance.surface == nullptr)
+    {
+      return -1;
+    }
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (Instance& instance : instances)
+  {
+    threads.emplace_back([&instance, duration_ms] {
+      HalContextBinding binding(*instance.context);
+      // Too large for the stack of a thread
+      auto app = std::make_unique<App>();
+      app->init();
+      run_script(duration_ms, instance.events, instance.surface, [&app] { app->tick(); });
+    });
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  const auto real_ms =
+    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  printf(
+    "Simulated %d instances for %llu s in %lld ms\n",
+    script_count,
+    static_cast<unsigned long long>(duration_ms / 1000),
+    static_cast<long long>(real_ms));
+
+  for (Instance& instance : instances)
+  {
+    HalContextBinding binding(*instance.context);
+    printf("%s:\n", instance.script_path);
+    spi_bus_report();
+    SDL_FreeSurface(instance.surface);
+  }
+  return 0;
+}
+}  // namespace
+
+int main(int argc, char* args[])
+{
+  if (argc < 2)
+  {
+    printf("Invalid arguments, usage: headless <simulated duration in s> [path/to/script.txt...]\n");
+    return -1;
+  }
+  const uint64_t duration_ms = static_cast<uint64_t>(atof(args[1]) * 1000);
+  if (argc > 3)
+  {
+    return run_instances(duration_ms, argc - 2, args + 2);
+  }
+  std::vector<ScriptEvent> events;
+  if (argc == 3 && !parse_script(args[2], events))
+  {
+    return -1;
+  }
+
+  SDL_Surface* screen_surface = create_screen();
+  if (screen_surface == nullptr)
+  {
+    return -1;
+  }
+
+  sim_clock_use_virtual_time(true);
+  const auto start = std::chrono::steady_clock::now();
+
+  // Call arduino's setup
+  setup();
+
+  // Execute main loop of arduino
+  run_script(duration_ms, events, screen_surface, loop);
+
+  const auto real_ms =
+    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  printf(
+    "Simulated %llu s in %lld ms\n",
+    static_cast<unsigned long long>(duration_ms / 1000),
+    static_cast<long long>(real_ms));
+  // What the run would have cost on the device
+  spi_bus_report();
+  SDL_FreeSurface(screen_surface);
+  return 0;
+}
@@ -1,10 +1,14 @@
 #include "audio_ampli_mcu/LCD_Driver.h"
 #include "sim/lcd_simulator.h"
+#include "sim/overdraw_profiler.h"
 #include "sim/pio_encoder.h"
+#include "sim/spi_bus_model.h"
 #include "sim/toggle_button.h"
 
 #include <SDL.h>
+#include <cstring>
 #include <stdio.h>
+#include <vector>
 
 void setup();
 void loop();
@@ -17,6 +21,11 @@ int main(int argc, char* args[])
   // The surface contained by the window
   SDL_Surface* screenSurface = NULL;
   bool quit = false;
+  // Press H to show where the pixels are written, and print the writes per view every second
+  bool show_overdraw = false;
+  // Press B to print the time the SPI bus would take on the device every second
+  bool show_bus_time = false;
+  std::vector<uint8_t> screen_pixels;
 
   // Initialize SDL
   if (SDL_Init(SDL_INIT_VIDEO) < 0)
@@ -39,9 +48,22 @@ int main(int argc, char* args[])
   }
   // Get window surface
   screenSurface = SDL_GetWindowSurface(window);
-  auto blip_screen = [&quit, &window]() {
+  auto blip_screen = [&quit, &window, &show_overdraw, &show_bus_time, &screen_pixels, &screenSurface]() {
     SDL_Event event;
-    SDL_UpdateWindowSurface(window);
+    if (show_overdraw)
+    {
+      // The heatmap is drawn over the screen only for the update of the window, the LCD simulator keeps drawing in
+      // the surface
+      const auto* pixels = static_cast<const uint8_t*>(screenSurface->pixels);
+      screen_pixels.assign(pixels, pixels + screenSurface->pitch * screenSurface->h);
+      overdraw_draw_heatmap(screenSurface);
+      SDL_UpdateWindowSurface(window);
+      memcpy(screenSurface->pixels, screen_pixels.data(), screen_pixels.size());
+    }
+    else
+    {
+      SDL_UpdateWindowSurface(window);
+    }
     while (SDL_PollEvent(&event))
     {
       switch (event.type)
@@ -70,6 +92,12 @@ int main(int argc, char* args[])
             case SDLK_e:
               button_pressed(17, event.key.repeat != 0);
               break;
+            case SDLK_h:
+              show_overdraw = !show_overdraw;
+              break;
+            case SDLK_b:
+              show_bus_time = !show_bus_time;
+              break;
             default:
               break;
           }
@@ -104,20 +132,32 @@ int main(int argc, char* args[])
 
   // SDL_Event event;
 
-  constexpr int FPS = 60;
-  constexpr int frameDelay = 1000 / FPS;
-  uint32_t frameStart = 0;
-  int frameTime = 0;
+  // The app paces its frames itself (see FrameScheduler), the loop only has to spin often enough for the inputs
+  constexpr int tickDelay = 2;
+  uint32_t tickStart = 0;
+  int tickTime = 0;
+  uint32_t last_overdraw_report_ms = 0;
+  uint32_t last_bus_report_ms = 0;
   while (!quit)
   {
-    frameStart = SDL_GetTicks();
+    tickStart = SDL_GetTicks();
     // Execute main loop of arduino
     loop();
     blip_screen();
-    frameTime = SDL_GetTicks() - frameStart;
-    if (frameDelay > frameTime)
+    if (show_overdraw && SDL_GetTicks() - last_overdraw_report_ms > 1000)
+    {
+      overdraw_report();
+      last_overdraw_report_ms = SDL_GetTicks();
+    }
+    if (show_bus_time && SDL_GetTicks() - last_bus_report_ms > 1000)
+    {
+      spi_bus_report();
+      last_bus_report_ms = SDL_GetTicks();
+    }
+    tickTime = SDL_GetTicks() - tickStart;
+    if (tickDelay > tickTime)
     {
-      SDL_Delay(frameDelay - frameTime);
+      SDL_Delay(tickDelay - tickTime);
     }
   }
   SDL_DestroyWindow(window);
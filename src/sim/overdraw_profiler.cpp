@@ -0,0 +1,107 @@
+#include "sim/overdraw_profiler.h"
+
+#include "audio_ampli_mcu/LCD_Driver.h"
+#include "sim/hal_context.h"
+
+#include <SDL.h>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+using ViewStats = HalContext::Overdraw::ViewStats;
+}  // namespace
+
+void overdraw_count_writes(const uint16_t x, const uint16_t y, const uint16_t width, const uint16_t height)
+{
+  HalContext::Overdraw& overdraw = hal_context().overdraw;
+  if (overdraw.view_stats.empty())
+  {
+    overdraw_begin_view("App");
+  }
+  ViewStats& stats = overdraw.view_stats[overdraw.current_view];
+  for (uint32_t row = y; row < static_cast<uint32_t>(y + height) && row < LCD_HEIGHT; ++row)
+  {
+    for (uint32_t col = x; col < static_cast<uint32_t>(x + width) && col < LCD_WIDTH; ++col)
+    {
+      uint8_t& count = overdraw.frame_counts[row][col];
+      if (count > 0)
+      {
+        ++stats.overwrite_count;
+      }
+      if (count < 0xff)
+      {
+        ++count;
+      }
+      ++stats.write_count;
+    }
+  }
+  overdraw.has_frame_writes = true;
+}
+
+void overdraw_begin_view(const char* name)
+{
+  HalContext::Overdraw& overdraw = hal_context().overdraw;
+  for (size_t i = 0; i < overdraw.view_stats.size(); ++i)
+  {
+    if (strcmp(overdraw.view_stats[i].name, name) == 0)
+    {
+      overdraw.current_view = i;
+      return;
+    }
+  }
+  overdraw.view_stats.push_back(ViewStats{.name = name});
+  overdraw.current_view = overdraw.view_stats.size() - 1;
+}
+
+void overdraw_end_frame()
+{
+  HalContext::Overdraw& overdraw = hal_context().overdraw;
+  if (!overdraw.has_frame_writes)
+  {
+    return;
+  }
+  memcpy(overdraw.heatmap_counts, overdraw.frame_counts, sizeof(overdraw.heatmap_counts));
+  memset(overdraw.frame_counts, 0, sizeof(overdraw.frame_counts));
+  overdraw.has_frame_writes = false;
+}
+
+void overdraw_draw_heatmap(SDL_Surface* surface)
+{
+  // Written once, twice, three times, four times or more
+  constexpr uint8_t heat_colors[4][3] = {{0x00, 0xff, 0x00}, {0xff, 0xff, 0x00}, {0xff, 0x80, 0x00}, {0xff, 0x00, 0x00}};
+  const HalContext::Overdraw& overdraw = hal_context().overdraw;
+  for (uint32_t y = 0; y < LCD_HEIGHT; ++y)
+  {
+    uint8_t* row = static_cast<uint8_t*>(surface->pixels) + y * surface->pitch;
+    for (uint32_t x = 0; x < LCD_WIDTH; ++x)
+    {
+      const uint8_t count = overdraw.heatmap_counts[y][x];
+      if (count == 0)
+      {
+        continue;
+      }
+      const uint8_t* color = heat_colors[count > 4 ? 3 : count - 1];
+      uint8_t* pixel = row + x * surface->format->BytesPerPixel;
+      // Due to little endianness it's BGR, not RGB
+      pixel[0] = (pixel[0] + color[2]) / 2;
+      pixel[1] = (pixel[1] + color[1]) / 2;
+      pixel[2] = (pixel[2] + color[0]) / 2;
+    }
+  }
+}
+
+void overdraw_report()
+{
+  for (ViewStats& stats : hal_context().overdraw.view_stats)
+  {
+    if (stats.write_count == 0)
+    {
+      continue;
+    }
+    std::cout << "Overdraw " << stats.name << ": " << stats.write_count << " px written, " << stats.overwrite_count
+              << " painted over (" << stats.overwrite_count * 100 / stats.write_count << "%)" << std::endl;
+    stats.write_count = 0;
+    stats.overwrite_count = 0;
+  }
+}
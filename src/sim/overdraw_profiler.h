@@ -0,0 +1,27 @@
+#ifndef OVERDRAW_PROFILER_GUARD_H_
+#define OVERDRAW_PROFILER_GUARD_H_
+
+#include <cstdint>
+
+// forward declaration
+class SDL_Surface;
+
+/// Count the writes of a rectangle of the framebuffer, `width` x `height` pixels starting at (x, y)
+void overdraw_count_writes(const uint16_t x, const uint16_t y, const uint16_t width, const uint16_t height);
+
+/// Attribute the next writes to a view, until the next call. The writes of the display list (LCD_DISPLAY_LIST)
+/// happen when the framebuffer is blipped, they are attributed to whoever is current then.
+void overdraw_begin_view(const char* name);
+
+/// End of a frame: the per pixel counters of the frame become the heatmap, if anything was written
+void overdraw_end_frame();
+
+/// Blend the heatmap of the last frame which wrote pixels over the surface: green for pixels written once, then
+/// yellow, orange and red for pixels written 4 times or more. Untouched pixels are left as is.
+void overdraw_draw_heatmap(SDL_Surface* surface);
+
+/// Print the pixel writes per view since the last report, and how many of them were painting over a pixel already
+/// written in the same frame
+void overdraw_report();
+
+#endif  // OVERDRAW_PROFILER_GUARD_H_
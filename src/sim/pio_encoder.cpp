@@ -1,20 +1,20 @@
 #include "sim/pio_encoder.h"
 
-int count[40] = {0};
+#include "sim/hal_context.h"
 
 void increment_encoder(const uint8_t encoder_pin, const int increment)
 {
-  if (encoder_pin < 40)
+  if (encoder_pin < HalContext::input_pin_count)
   {
-    count[encoder_pin] += increment;
+    hal_context().encoder_counts[encoder_pin] += increment;
   }
 }
 
 void decrement_encoder(const uint8_t encoder_pin, const int increment)
 {
-  if (encoder_pin < 40)
+  if (encoder_pin < HalContext::input_pin_count)
   {
-    count[encoder_pin] -= increment;
+    hal_context().encoder_counts[encoder_pin] -= increment;
   }
 }
 
@@ -36,5 +36,5 @@ void PioEncoder::flip(const bool x)
 
 int PioEncoder::getCount()
 {
-  return count[pin];
+  return hal_context().encoder_counts[pin];
 }
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "sim/sim_clock.h"
+
+#include "sim/hal_context.h"
+
+#include <SDL.h>
+
+void sim_clock_use_virtual_time(const bool enable)
+{
+  hal_context().clock.is_virtual_time = enable;
+}
+
+bool sim_clock_is_virtual()
+{
+  return hal_context().clock.is_virtual_time;
+}
+
+uint64_t sim_clock_millis()
+{
+  HalContext::Clock& clock = hal_context().clock;
+  if (clock.is_virtual_time)
+  {
+    clock.virtual_time_us += virtual_clock_read_cost_us;
+    return clock.virtual_time_us / 1000;
+  }
+  return SDL_GetTicks();
+}
+
+uint64_t sim_clock_micros()
+{
+  HalContext::Clock& clock = hal_context().clock;
+  if (clock.is_virtual_time)
+  {
+    clock.virtual_time_us += virtual_clock_read_cost_us;
+    return clock.virtual_time_us;
+  }
+  return SDL_GetPerformanceCounter() / (SDL_GetPerformanceFrequency() / 1000000);
+}
+
+void sim_clock_wait_us(const uint64_t duration_us)
+{
+  HalContext::Clock& clock = hal_context().clock;
+  if (clock.is_virtual_time)
+  {
+    clock.virtual_time_us += duration_us;
+    return;
+  }
+  SDL_Delay(static_cast<uint32_t>(duration_us / 1000));
+}
@@ -0,0 +1,20 @@
+#ifndef SIM_CLOCK_GUARD_H_
+#define SIM_CLOCK_GUARD_H_
+
+#include <cstdint>
+
+/// Clock behind millis(), micros() and delay() in the simulator. It's the wall clock by default, waiting sleeps.
+/// The virtual clock only moves when the simulated code waits (delay(), SPI transfers) or reads it, so a run goes as
+/// fast as the host allows and gives the same result every time. Each HalContext has its own clock.
+void sim_clock_use_virtual_time(const bool enable);
+bool sim_clock_is_virtual();
+
+uint64_t sim_clock_millis();
+uint64_t sim_clock_micros();
+/// Sleep, or move the virtual clock forward
+void sim_clock_wait_us(const uint64_t duration_us);
+
+/// Each read of the virtual clock costs this much, so a loop polling for the end of a transfer makes progress
+constexpr uint64_t virtual_clock_read_cost_us = 1;
+
+#endif  // SIM_CLOCK_GUARD_H_
@@ -0,0 +1,187 @@
+#include "sim/spi_bus_model.h"
+
+#include "sim/hal_context.h"
+#include "sim/sim_clock.h"
+
+#include <algorithm>
+#include <stdio.h>
+
+namespace
+{
+/// clk_peri of the arduino-pico core, the SPI clock is divided from it
+constexpr uint64_t peripheral_clock_hz = 133000000;
+/// The PL022 leaves a gap of a few clocks between the bytes of a burst: with the clock asked at 20MHz (16.6MHz in
+/// practice) the screen takes 1us/px, i.e. 11 clocks per byte instead of 8
+constexpr uint64_t clocks_per_byte = 8 + 3;
+/// Call of SPI.transfer(): filling the FIFO, then waiting for the last byte to come back
+constexpr uint64_t transfer_call_ns = 600;
+/// digitalWrite() of a chip select or data/command pin
+constexpr uint64_t pin_write_ns = 100;
+/// SPI.beginTransaction() and SPI.endTransaction(), and setting the format and baudrate when another device used
+/// the bus with other settings
+constexpr uint64_t transaction_ns = 800;
+constexpr uint64_t reconfigure_ns = 1500;
+/// Setting up the DMA channel for SPI.transferAsync()
+constexpr uint64_t dma_setup_ns = 2000;
+
+constexpr const char* device_names[] = {"lcd", "io_expander"};
+static_assert(sizeof(device_names) / sizeof(device_names[0]) == static_cast<size_t>(SpiDevice::count));
+
+using DeviceStats = HalContext::SpiBus::DeviceStats;
+using PeriodStats = HalContext::SpiBus::PeriodStats;
+
+uint64_t bytes_duration_ns(const uint64_t byte_count, const uint32_t clock)
+{
+  return byte_count * clocks_per_byte * 1000000000ull / clock;
+}
+
+void wait(HalContext::SpiBus& bus, const uint64_t duration_ns)
+{
+  if (!bus.is_transfer_time_simulated)
+  {
+    return;
+  }
+  bus.pending_wait_ns += duration_ns;
+  // The wall clock sleeps by whole ms
+  const uint64_t resolution_ns = sim_clock_is_virtual() ? 1000 : 1000000;
+  const uint64_t waited_ns = bus.pending_wait_ns - bus.pending_wait_ns % resolution_ns;
+  if (waited_ns > 0)
+  {
+    sim_clock_wait_us(waited_ns / 1000);
+    bus.pending_wait_ns -= waited_ns;
+  }
+}
+
+void account(HalContext::SpiBus& bus, const SpiDevice device, const uint64_t duration_ns)
+{
+  bus.device_stats[static_cast<size_t>(device)].busy_ns += duration_ns;
+  bus.tick_busy_ns += duration_ns;
+  bus.frame_busy_ns += duration_ns;
+}
+
+void end_period(PeriodStats& stats, uint64_t& busy_ns)
+{
+  ++stats.count;
+  stats.total_ns += busy_ns;
+  stats.max_ns = std::max(stats.max_ns, busy_ns);
+  busy_ns = 0;
+}
+
+void print_period(const char* name, PeriodStats& stats)
+{
+  if (stats.count == 0)
+  {
+    return;
+  }
+  printf(
+    "SPI bus per %s: %.2f ms avg, %.2f ms max over %u %ss\n",
+    name,
+    static_cast<double>(stats.total_ns / stats.count) / 1e6,
+    static_cast<double>(stats.max_ns) / 1e6,
+    stats.count,
+    name);
+  stats = PeriodStats{};
+}
+}  // namespace
+
+uint32_t spi_bus_effective_clock_hz(const uint32_t requested_clock_hz)
+{
+  // Same search as spi_set_baudrate() of the pico SDK: the fastest clock which isn't above the one asked for
+  uint64_t prescale = 2;
+  for (; prescale <= 254; prescale += 2)
+  {
+    if (peripheral_clock_hz < (prescale + 2) * 256 * requested_clock_hz)
+    {
+      break;
+    }
+  }
+  uint64_t postdiv = 256;
+  for (; postdiv > 1; --postdiv)
+  {
+    if (peripheral_clock_hz / (prescale * (postdiv - 1)) > requested_clock_hz)
+    {
+      break;
+    }
+  }
+  return static_cast<uint32_t>(peripheral_clock_hz / (prescale * postdiv));
+}
+
+void spi_bus_begin_transaction(const SpiDevice device, const uint32_t requested_clock_hz)
+{
+  HalContext::SpiBus& bus = hal_context().spi_bus;
+  const uint32_t new_clock_hz = spi_bus_effective_clock_hz(requested_clock_hz);
+  const uint64_t duration_ns = transaction_ns + (new_clock_hz != bus.clock_hz ? reconfigure_ns : 0);
+  bus.clock_hz = new_clock_hz;
+  account(bus, device, duration_ns);
+  wait(bus, duration_ns);
+}
+
+void spi_bus_write_pin(const SpiDevice device)
+{
+  HalContext::SpiBus& bus = hal_context().spi_bus;
+  account(bus, device, pin_write_ns);
+  wait(bus, pin_write_ns);
+}
+
+void spi_bus_transfer(const SpiDevice device, const size_t byte_count)
+{
+  HalContext::SpiBus& bus = hal_context().spi_bus;
+  const uint64_t duration_ns = transfer_call_ns + bytes_duration_ns(byte_count, bus.clock_hz);
+  bus.device_stats[static_cast<size_t>(device)].byte_count += byte_count;
+  account(bus, device, duration_ns);
+  wait(bus, duration_ns);
+}
+
+void spi_bus_start_dma(const SpiDevice device, const size_t byte_count)
+{
+  HalContext::SpiBus& bus = hal_context().spi_bus;
+  bus.dma_clock_hz = bus.clock_hz;
+  bus.device_stats[static_cast<size_t>(device)].byte_count += byte_count;
+  account(bus, device, dma_setup_ns + bytes_duration_ns(byte_count, bus.dma_clock_hz));
+  // Only the setup blocks, the bytes go out while the CPU does something else
+  wait(bus, dma_setup_ns);
+}
+
+size_t spi_bus_dma_bytes_sent(const uint64_t elapsed_us)
+{
+  return static_cast<size_t>(elapsed_us * hal_context().spi_bus.dma_clock_hz / (clocks_per_byte * 1000000));
+}
+
+void spi_bus_simulate_transfer_time(const bool enable)
+{
+  hal_context().spi_bus.is_transfer_time_simulated = enable;
+}
+
+void spi_bus_end_tick()
+{
+  HalContext::SpiBus& bus = hal_context().spi_bus;
+  end_period(bus.tick_stats, bus.tick_busy_ns);
+}
+
+void spi_bus_end_frame()
+{
+  HalContext::SpiBus& bus = hal_context().spi_bus;
+  end_period(bus.frame_stats, bus.frame_busy_ns);
+}
+
+void spi_bus_report()
+{
+  HalContext::SpiBus& bus = hal_context().spi_bus;
+  print_period("frame", bus.frame_stats);
+  print_period("tick", bus.tick_stats);
+
+  const uint64_t now_us = sim_clock_micros();
+  const uint64_t elapsed_us = std::max<uint64_t>(now_us - bus.last_report_us, 1);
+  bus.last_report_us = now_us;
+  for (size_t i = 0; i < static_cast<size_t>(SpiDevice::count); ++i)
+  {
+    DeviceStats& stats = bus.device_stats[i];
+    printf(
+      "SPI bus %s: %llu bytes in %.2f ms, busy %llu%% of the time\n",
+      device_names[i],
+      static_cast<unsigned long long>(stats.byte_count),
+      static_cast<double>(stats.busy_ns) / 1e6,
+      static_cast<unsigned long long>(stats.busy_ns / 10 / elapsed_us));
+    stats = DeviceStats{};
+  }
+}
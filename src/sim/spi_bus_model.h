@@ -0,0 +1,46 @@
+#ifndef SPI_BUS_MODEL_GUARD_H_
+#define SPI_BUS_MODEL_GUARD_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/// Devices sharing the SPI bus, the time on the bus is accounted per device
+enum class SpiDevice : uint8_t
+{
+  lcd = 0,
+  io_expander,
+  count
+};
+
+/// Predicts the time the RP2040 would spend on the SPI bus, from what the firmware does with it: the clock it asks
+/// for (rounded down to what the SPI divider can make), the bytes sent, the overhead of each call and transaction, and
+/// the chip select and data/command pins toggled by software. Blocking transfers move the simulated clock by the
+/// predicted time, so the simulator runs at the speed of the device. The figures are estimates, calibrate them
+/// against a logic analyzer if the predictions drift from the device.
+
+/// SPI.beginTransaction() with the clock of SPISettings, the cost of endTransaction() is included
+void spi_bus_begin_transaction(const SpiDevice device, const uint32_t requested_clock_hz);
+/// A chip select or data/command pin of the device written with digitalWrite()
+void spi_bus_write_pin(const SpiDevice device);
+/// `byte_count` bytes sent by one blocking call of SPI.transfer()
+void spi_bus_transfer(const SpiDevice device, const size_t byte_count);
+/// Start of a DMA transfer of `byte_count` bytes, which runs in the background
+void spi_bus_start_dma(const SpiDevice device, const size_t byte_count);
+/// Bytes the DMA transfer started `elapsed_us` ago has sent by now
+size_t spi_bus_dma_bytes_sent(const uint64_t elapsed_us);
+
+/// Clock the RP2040 runs the bus at when asked for `requested_clock_hz`
+uint32_t spi_bus_effective_clock_hz(const uint32_t requested_clock_hz);
+
+/// When enabled (the default), blocking transfers wait for their predicted time on the simulated clock
+void spi_bus_simulate_transfer_time(const bool enable);
+
+/// End of an App::tick() and of a frame: the bus time since the previous one goes to the per tick or per frame stats.
+/// A DMA transfer counts in full in the tick and frame which started it.
+void spi_bus_end_tick();
+void spi_bus_end_frame();
+
+/// Print the predicted bus time per frame and per tick, and per device, since the last report
+void spi_bus_report();
+
+#endif  // SPI_BUS_MODEL_GUARD_H_
@@ -1,30 +1,28 @@
 #include "sim/toggle_button.h"
 
 #include "sim/arduino.h"
+#include "sim/hal_context.h"
 
 #define LONG_PRESS_DURATION_MS 1000
 
-bool button_state[40] = {0};
-int when_press_ms[40] = {0};
-int when_released_ms[40] = {0};
-
 void button_pressed(const uint8_t pin, const bool is_repeat)
 {
-  if (pin < 40)
+  if (pin < HalContext::input_pin_count)
   {
-    button_state[pin] = !button_state[pin];
+    HalContext::Button& button = hal_context().buttons[pin];
+    button.state = !button.state;
     if (!is_repeat)
     {
-      when_press_ms[pin] = millis();
-      when_released_ms[pin] = -1;
+      button.when_press_ms = millis();
+      button.when_released_ms = -1;
     }
   }
 }
 void button_released(const uint8_t pin)
 {
-  if (pin < 40)
+  if (pin < HalContext::input_pin_count)
   {
-    when_released_ms[pin] = millis();
+    hal_context().buttons[pin].when_released_ms = millis();
   }
 }
 
@@ -51,23 +49,24 @@ bool ToggleButton::get_state() const
 
 void ToggleButton::process(unsigned long)
 {
-  state_ = button_state[pin_in_];
+  HalContext::Button& button = hal_context().buttons[pin_in_];
+  state_ = button.state;
   // Button was released
-  if (when_press_ms[pin_in_] > 0 && when_released_ms[pin_in_] > 0)
+  if (button.when_press_ms > 0 && button.when_released_ms > 0)
   {
-    const auto duration_ms = when_released_ms[pin_in_] - when_press_ms[pin_in_];
+    const auto duration_ms = button.when_released_ms - button.when_press_ms;
     flag_long_pressed_ = duration_ms > LONG_PRESS_DURATION_MS;
     flag_short_pressed_ = !flag_long_pressed_;
-    when_press_ms[pin_in_] = -1;
-    when_released_ms[pin_in_] = -1;
+    button.when_press_ms = -1;
+    button.when_released_ms = -1;
   }
   // Button has not yet been released, but it has been pressed long enough
-  else if (when_press_ms[pin_in_] > 0 && millis() - when_press_ms[pin_in_] > LONG_PRESS_DURATION_MS)
+  else if (button.when_press_ms > 0 && millis() - button.when_press_ms > LONG_PRESS_DURATION_MS)
   {
     flag_long_pressed_ = true;
     flag_short_pressed_ = false;
-    when_press_ms[pin_in_] = -1;
-    when_released_ms[pin_in_] = -1;
+    button.when_press_ms = -1;
+    button.when_released_ms = -1;
   }
   else
   {